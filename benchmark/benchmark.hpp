@@ -0,0 +1,148 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// A minimal microbenchmark runner in the style of Google Benchmark. It
+/// has no dependencies so the benchmarks build everywhere bnb builds.
+namespace benchmark
+{
+/// The state passed to a benchmark function. The function must run the
+/// code to measure in a while (state.keep_running()) loop.
+class state
+{
+public:
+
+    /// Constructs a state running a given number of iterations
+    /// @param iterations The number of iterations to run
+    state(uint64_t iterations) :
+        m_iterations(iterations),
+        m_remaining(iterations)
+    { }
+
+    /// Starts the timer on the first call and stops it after the last
+    /// iteration.
+    /// @return true if another iteration should be run
+    bool keep_running()
+    {
+        if (m_remaining == m_iterations)
+            m_start = clock::now();
+
+        if (m_remaining == 0)
+        {
+            m_stop = clock::now();
+            return false;
+        }
+
+        --m_remaining;
+        return true;
+    }
+
+    /// Sets the number of items, e.g. fields, processed in total
+    void set_items_processed(uint64_t items)
+    {
+        m_items = items;
+    }
+
+    /// Sets the number of bytes processed in total
+    void set_bytes_processed(uint64_t bytes)
+    {
+        m_bytes = bytes;
+    }
+
+    /// @return The number of iterations to run
+    uint64_t iterations() const
+    {
+        return m_iterations;
+    }
+
+    /// @return The number of items processed in total
+    uint64_t items_processed() const
+    {
+        return m_items;
+    }
+
+    /// @return The number of bytes processed in total
+    uint64_t bytes_processed() const
+    {
+        return m_bytes;
+    }
+
+    /// @return The time spent running the iterations in nanoseconds
+    double elapsed_ns() const
+    {
+        return std::chrono::duration<double, std::nano>(
+            m_stop - m_start).count();
+    }
+
+private:
+
+    using clock = std::chrono::steady_clock;
+
+    uint64_t m_iterations;
+    uint64_t m_remaining;
+    uint64_t m_items = 0;
+    uint64_t m_bytes = 0;
+    clock::time_point m_start;
+    clock::time_point m_stop;
+};
+
+/// Prevents the compiler from optimizing away the computation of a value
+template<class Type>
+inline void do_not_optimize(const Type& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/// A registered benchmark
+struct benchmark_info
+{
+    std::string name;
+    std::function<void(state&)> function;
+};
+
+/// @return All registered benchmarks
+inline std::vector<benchmark_info>& benchmarks()
+{
+    static std::vector<benchmark_info> registered;
+    return registered;
+}
+
+/// Registers a benchmark, used to initialize a static variable.
+/// @return Always true
+inline bool register_benchmark(
+    const std::string& name, std::function<void(state&)> function)
+{
+    benchmarks().push_back({name, function});
+    return true;
+}
+
+/// Runs the registered benchmarks which contain the filter in their name
+/// and prints the results.
+/// @param filter The filter to match, the empty string matches everything
+/// @param min_time_ns The minimum time to run each benchmark
+void run_benchmarks(const std::string& filter, double min_time_ns);
+}
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+
+/// Registers a function taking a benchmark::state& as a benchmark. The
+/// macro is variadic so template instances, e.g. BENCHMARK(f<a, b>), can be
+/// registered directly.
+#define BENCHMARK(...)                                                      \
+    static bool BENCHMARK_CONCAT(benchmark_registered_, __LINE__) =          \
+        benchmark::register_benchmark(#__VA_ARGS__, __VA_ARGS__)
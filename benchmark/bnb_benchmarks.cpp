@@ -0,0 +1,61 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "benchmark.hpp"
+
+namespace benchmark
+{
+void run_benchmarks(const std::string& filter, double min_time_ns)
+{
+    std::printf("%-56s %12s %12s %12s\n",
+                "benchmark", "ns/iter", "ns/field", "MB/s");
+
+    for (const auto& info : benchmarks())
+    {
+        if (info.name.find(filter) == std::string::npos)
+            continue;
+
+        // Grow the number of iterations until the run is long enough to
+        // give a stable result
+        uint64_t iterations = 1;
+        while (true)
+        {
+            benchmark::state state(iterations);
+            info.function(state);
+
+            double elapsed = state.elapsed_ns();
+            if (elapsed >= min_time_ns || iterations >= (1ULL << 40))
+            {
+                double per_iteration = elapsed / iterations;
+                double per_item = state.items_processed() == 0 ? 0.0 :
+                    elapsed / state.items_processed();
+                double mb_per_second = state.bytes_processed() == 0 ? 0.0 :
+                    state.bytes_processed() * 1e3 / elapsed;
+
+                std::printf("%-56s %12.2f %12.3f %12.1f\n", info.name.c_str(),
+                            per_iteration, per_item, mb_per_second);
+                break;
+            }
+
+            iterations *= elapsed < min_time_ns / 100 ? 10 : 2;
+        }
+    }
+}
+}
+
+/// Usage: bnb_benchmarks [filter] [min_time_seconds]
+int main(int argc, char** argv)
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+    double min_time_seconds = argc > 2 ? std::atof(argv[2]) : 0.2;
+
+    benchmark::run_benchmarks(filter, min_time_seconds * 1e9);
+    return 0;
+}
@@ -0,0 +1,153 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/bit_stream_reader.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+// Reads fields of a fixed width back-to-back, so most fields are not byte
+// aligned
+template<class BitNumbering, uint32_t Bits>
+void bit_stream_read_bits(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const uint64_t fields = buffer.size() * 8 / Bits;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::bit_stream_reader<BitNumbering> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < fields; ++i)
+        {
+            uint64_t value = 0;
+            reader.template read_bits<Bits>(value);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(bit_stream_read_bits<bitter::msb0, 1>);
+BENCHMARK(bit_stream_read_bits<bitter::msb0, 5>);
+BENCHMARK(bit_stream_read_bits<bitter::msb0, 13>);
+BENCHMARK(bit_stream_read_bits<bitter::msb0, 31>);
+BENCHMARK(bit_stream_read_bits<bitter::msb0, 64>);
+BENCHMARK(bit_stream_read_bits<bitter::lsb0, 5>);
+BENCHMARK(bit_stream_read_bits<bitter::lsb0, 13>);
+
+// Reads fields of random widths from 1 to 32 bits known only at runtime
+template<class BitNumbering>
+void bit_stream_read_bits_runtime(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    std::vector<uint32_t> widths;
+    std::mt19937 random(0);
+    uint64_t total_bits = 0;
+    while (true)
+    {
+        uint32_t bits = random() % 32 + 1;
+        if (total_bits + bits > buffer.size() * 8)
+            break;
+        widths.push_back(bits);
+        total_bits += bits;
+    }
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::bit_stream_reader<BitNumbering> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint32_t bits : widths)
+        {
+            uint64_t value = 0;
+            reader.read_bits(value, bits);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * widths.size());
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(bit_stream_read_bits_runtime<bitter::msb0>);
+BENCHMARK(bit_stream_read_bits_runtime<bitter::lsb0>);
+
+// Writes the Exp-Golomb codes of small random values, as found in the slice
+// headers of H.264 and H.265
+std::vector<uint8_t> exp_golomb_codes(uint64_t& count)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0);
+    std::mt19937 random(0);
+    uint64_t position = 0;
+    count = 0;
+    while (true)
+    {
+        uint64_t code = random() % 32 + 1;
+        uint32_t bits = 0;
+        while ((code >> bits) > 1)
+            ++bits;
+        if (position + 2 * bits + 1 > buffer.size() * 8)
+            break;
+
+        position += bits;
+        for (uint32_t i = bits + 1; i > 0; --i, ++position)
+        {
+            uint8_t bit = (code >> (i - 1)) & 1;
+            buffer[position / 8] |= (uint8_t)(bit << (7 - position % 8));
+        }
+        ++count;
+    }
+    return buffer;
+}
+
+template<class Filter>
+void bit_stream_read_exp_golomb(benchmark::state& state)
+{
+    uint64_t count = 0;
+    std::vector<uint8_t> buffer = exp_golomb_codes(count);
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::bit_stream_reader<bitter::msb0, Filter> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint32_t value = 0;
+            reader.read_exp_golomb(value);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * count);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(bit_stream_read_exp_golomb<bnb::no_filter>);
+BENCHMARK(bit_stream_read_exp_golomb<bnb::emulation_prevention>);
+}
@@ -0,0 +1,93 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/byte_order.hpp>
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+// Reads 4 byte fields of a runtime byte order by branching between two
+// readers for every field
+void byte_order_branch_per_field(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const uint64_t fields = buffer.size() / 4;
+    bool little_endian = true;
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(little_endian);
+
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> big_endian_reader(
+            buffer.data(), buffer.size(), error);
+        bnb::stream_reader<endian::little_endian> little_endian_reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < fields; ++i)
+        {
+            uint32_t value = 0;
+            if (little_endian)
+                little_endian_reader.read_bytes<4>(value).expect_ne(0);
+            else
+                big_endian_reader.read_bytes<4>(value).expect_ne(0);
+            sum += value;
+            benchmark::do_not_optimize(little_endian);
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(byte_order_branch_per_field);
+
+// Reads the same fields with the byte order dispatched once
+void byte_order_dispatch(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const uint64_t fields = buffer.size() / 4;
+    auto order = bnb::byte_order::little_endian;
+
+    while (state.keep_running())
+    {
+        benchmark::do_not_optimize(order);
+
+        std::error_code error;
+        uint64_t sum = bnb::parse_with_byte_order(
+            order, buffer.data(), buffer.size(), error,
+            [fields](auto& reader)
+        {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < fields; ++i)
+            {
+                uint32_t value = 0;
+                reader.template read_bytes<4>(value).expect_ne(0);
+                sum += value;
+            }
+            return sum;
+        });
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(byte_order_dispatch);
+}
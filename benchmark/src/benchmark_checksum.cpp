@@ -0,0 +1,104 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/checksum.hpp>
+#include <bnb/checksum_reader.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+template<class Checksum>
+void checksum_update(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+
+    while (state.keep_running())
+    {
+        Checksum checksum;
+        checksum.update(buffer.data(), buffer.size());
+        auto value = checksum.value();
+        benchmark::do_not_optimize(value);
+    }
+
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(checksum_update<bnb::crc32>);
+BENCHMARK(checksum_update<bnb::crc32c>);
+BENCHMARK(checksum_update<bnb::internet_checksum>);
+
+// The slicing-by-8 fallback used without CRC instructions
+void checksum_update_crc32_table(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const auto& tables = bnb::detail::crc32_table<0xEDB88320>();
+
+    while (state.keep_running())
+    {
+        uint32_t crc = bnb::detail::crc32_update_table(
+            tables, 0xFFFFFFFF, buffer.data(), buffer.size());
+        benchmark::do_not_optimize(crc);
+    }
+
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(checksum_update_crc32_table);
+
+// Parses frames of a 2 byte length, 4 byte fields and a CRC-32C and
+// verifies them with a checksum_reader
+void checksum_reader_frames(benchmark::state& state)
+{
+    const uint64_t payload_size = 252;
+    std::vector<uint8_t> buffer;
+    while (buffer.size() + payload_size + 6 <= buffer_size)
+    {
+        std::vector<uint8_t> frame {0x00, (uint8_t)payload_size};
+        frame.resize(2 + payload_size, 0xAB);
+
+        bnb::crc32c crc;
+        crc.update(frame.data(), frame.size());
+        for (uint32_t shift : {24, 16, 8, 0})
+            frame.push_back((uint8_t)(crc.value() >> shift));
+        buffer.insert(buffer.end(), frame.begin(), frame.end());
+    }
+    const uint64_t frames = buffer.size() / (payload_size + 6);
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::checksum_reader<bnb::crc32c, endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < frames; ++i)
+        {
+            uint16_t length = 0;
+            reader.read_bytes<2>(length).expect_eq(payload_size);
+            for (uint64_t j = 0; j < payload_size / 4; ++j)
+            {
+                uint32_t value = 0;
+                reader.read_bytes<4>(value);
+                sum += value;
+            }
+            reader.expect_checksum<4>();
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * frames);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(checksum_reader_frames);
+}
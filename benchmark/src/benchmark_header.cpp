@@ -0,0 +1,308 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/layout.hpp>
+#include <bnb/stream_reader.hpp>
+#include <bnb/stream_writer.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+// Parses and writes a realistic 20 field packet header: an IPv4 header,
+// followed by a UDP header and a small application header.
+namespace
+{
+const uint64_t header_size = 42;
+const uint64_t header_fields = 20;
+const uint64_t headers = 64;
+
+std::vector<uint8_t> make_headers()
+{
+    std::vector<uint8_t> header =
+    {
+        0x45, 0x00, 0x00, 0x2A, 0x12, 0x34, 0x40, 0x00, 0x40, 0x11,
+        0x00, 0x00, 0xC0, 0xA8, 0x00, 0x01, 0xC0, 0xA8, 0x00, 0x02,
+        0x13, 0x88, 0x13, 0x89, 0x00, 0x16, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x03,
+        0x00, 0x04, 0x01, 0x00
+    };
+
+    std::vector<uint8_t> buffer;
+    for (uint64_t i = 0; i < headers; ++i)
+        buffer.insert(buffer.end(), header.begin(), header.end());
+    return buffer;
+}
+
+struct header
+{
+    uint8_t version;
+    uint8_t ihl;
+    uint8_t tos;
+    uint16_t total_length;
+    uint16_t identification;
+    uint8_t flags;
+    uint16_t fragment_offset;
+    uint8_t ttl;
+    uint8_t protocol;
+    uint16_t checksum;
+    uint32_t source;
+    uint32_t destination;
+    uint16_t source_port;
+    uint16_t destination_port;
+    uint16_t length;
+    uint16_t udp_checksum;
+    uint32_t sequence;
+    uint32_t timestamp;
+    uint16_t stream;
+    uint16_t window;
+    uint8_t type;
+    uint8_t reserved;
+};
+
+template<class Reader>
+void read_header(Reader& reader, header& h)
+{
+    reader.template read_bits<bitter::u8, bitter::msb0, 4, 4>()
+    .template get<0>(h.version).expect_eq(4)
+    .template get<1>(h.ihl).expect_eq(5);
+    reader.template read_bytes<1>(h.tos);
+    reader.template read_bytes<2>(h.total_length).expect_ge(header_size);
+    reader.template read_bytes<2>(h.identification);
+    reader.template read_bits<bitter::u16, bitter::msb0, 3, 13>()
+    .template get<0>(h.flags)
+    .template get<1>(h.fragment_offset);
+    reader.template read_bytes<1>(h.ttl).expect_ne(0);
+    reader.template read_bytes<1>(h.protocol).expect_eq(17);
+    reader.template read_bytes<2>(h.checksum);
+    reader.template read_bytes<4>(h.source);
+    reader.template read_bytes<4>(h.destination);
+    reader.template read_bytes<2>(h.source_port);
+    reader.template read_bytes<2>(h.destination_port);
+    reader.template read_bytes<2>(h.length).expect_ge(8);
+    reader.template read_bytes<2>(h.udp_checksum);
+    reader.template read_bytes<4>(h.sequence);
+    reader.template read_bytes<4>(h.timestamp);
+    reader.template read_bytes<2>(h.stream);
+    reader.template read_bytes<2>(h.window);
+    reader.template read_bytes<1>(h.type).expect_le(3);
+    reader.template read_bytes<1>(h.reserved).expect_eq(0);
+}
+
+void set_processed(benchmark::state& state)
+{
+    state.set_items_processed(state.iterations() * headers * header_fields);
+    state.set_bytes_processed(state.iterations() * headers * header_size);
+}
+
+void header_read_bytes(benchmark::state& state)
+{
+    auto buffer = make_headers();
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        header h;
+        for (uint64_t i = 0; i < headers; ++i)
+        {
+            read_header(reader, h);
+            benchmark::do_not_optimize(h);
+        }
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+BENCHMARK(header_read_bytes);
+
+void header_require(benchmark::state& state)
+{
+    auto buffer = make_headers();
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        header h;
+        for (uint64_t i = 0; i < headers; ++i)
+        {
+            auto window = reader.require(header_size);
+            read_header(window, h);
+            benchmark::do_not_optimize(h);
+        }
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+BENCHMARK(header_require);
+
+using header_layout = bnb::layout<
+    bnb::bits<bitter::u8, bitter::msb0, 4, 4>,
+    bnb::field<1>, bnb::field<2>, bnb::field<2>,
+    bnb::bits<bitter::u16, bitter::msb0, 3, 13>,
+    bnb::field<1>, bnb::field<1>, bnb::field<2>, bnb::field<4>,
+    bnb::field<4>, bnb::field<2>, bnb::field<2>, bnb::field<2>,
+    bnb::field<2>, bnb::field<4>, bnb::field<4>, bnb::field<2>,
+    bnb::field<2>, bnb::field<1>, bnb::field<1>>;
+
+void header_read_layout(benchmark::state& state)
+{
+    auto buffer = make_headers();
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        header_layout::value_type values;
+        for (uint64_t i = 0; i < headers; ++i)
+        {
+            reader.read_layout<header_layout>(values);
+            benchmark::do_not_optimize(values);
+        }
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+BENCHMARK(header_read_layout);
+
+// The header schema with the same checks as read_header()
+using checked_header_layout = bnb::layout<
+    bnb::checked<bnb::bits<bitter::u8, bitter::msb0, 4, 4>,
+                 bnb::element<0, bnb::eq<4>>, bnb::element<1, bnb::eq<5>>>,
+    bnb::field<1>,
+    bnb::checked<bnb::field<2>, bnb::ge<header_size>>,
+    bnb::field<2>,
+    bnb::bits<bitter::u16, bitter::msb0, 3, 13>,
+    bnb::checked<bnb::field<1>, bnb::ne<0>>,
+    bnb::checked<bnb::field<1>, bnb::eq<17>>,
+    bnb::field<2>, bnb::field<4>, bnb::field<4>, bnb::field<2>,
+    bnb::field<2>,
+    bnb::checked<bnb::field<2>, bnb::ge<8>>,
+    bnb::field<2>, bnb::field<4>, bnb::field<4>, bnb::field<2>,
+    bnb::field<2>,
+    bnb::checked<bnb::field<1>, bnb::le<3>>,
+    bnb::checked<bnb::field<1>, bnb::eq<0>>>;
+
+void header_read_checked_layout(benchmark::state& state)
+{
+    auto buffer = make_headers();
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        checked_header_layout::value_type values;
+        for (uint64_t i = 0; i < headers; ++i)
+        {
+            reader.read_layout<checked_header_layout>(values);
+            benchmark::do_not_optimize(values);
+        }
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+BENCHMARK(header_read_checked_layout);
+
+header parse_header()
+{
+    auto buffer = make_headers();
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    header h;
+    read_header(reader, h);
+    return h;
+}
+
+void header_write_bytes(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(header_size * headers);
+    const header h = parse_header();
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_writer<endian::big_endian> writer(
+            buffer.data(), buffer.size(), error);
+
+        for (uint64_t i = 0; i < headers; ++i)
+        {
+            writer.write_bits<bitter::u8, bitter::msb0, 4, 4>()
+            .set<0>(h.version).set<1>(h.ihl);
+            writer.write_bytes<1>(h.tos);
+            writer.write_bytes<2>(h.total_length);
+            writer.write_bytes<2>(h.identification);
+            writer.write_bits<bitter::u16, bitter::msb0, 3, 13>()
+            .set<0>(h.flags).set<1>(h.fragment_offset);
+            writer.write_bytes<1>(h.ttl);
+            writer.write_bytes<1>(h.protocol);
+            writer.write_bytes<2>(h.checksum);
+            writer.write_bytes<4>(h.source);
+            writer.write_bytes<4>(h.destination);
+            writer.write_bytes<2>(h.source_port);
+            writer.write_bytes<2>(h.destination_port);
+            writer.write_bytes<2>(h.length);
+            writer.write_bytes<2>(h.udp_checksum);
+            writer.write_bytes<4>(h.sequence);
+            writer.write_bytes<4>(h.timestamp);
+            writer.write_bytes<2>(h.stream);
+            writer.write_bytes<2>(h.window);
+            writer.write_bytes<1>(h.type);
+            writer.write_bytes<1>(h.reserved);
+        }
+        benchmark::do_not_optimize(buffer.data());
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+BENCHMARK(header_write_bytes);
+
+// Writes the headers with a layout, which is either schema of the header
+template<class Layout>
+void write_layout(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(header_size * headers);
+    const header h = parse_header();
+    const typename Layout::value_type values
+    {
+        {{h.version, h.ihl}}, h.tos, h.total_length, h.identification,
+        {{h.flags, h.fragment_offset}}, h.ttl, h.protocol, h.checksum,
+        h.source, h.destination, h.source_port, h.destination_port,
+        h.length, h.udp_checksum, h.sequence, h.timestamp, h.stream,
+        h.window, h.type, h.reserved
+    };
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_writer<endian::big_endian> writer(
+            buffer.data(), buffer.size(), error);
+
+        for (uint64_t i = 0; i < headers; ++i)
+            writer.write_layout<Layout>(values);
+
+        benchmark::do_not_optimize(buffer.data());
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+
+void header_write_layout(benchmark::state& state)
+{
+    write_layout<header_layout>(state);
+}
+BENCHMARK(header_write_layout);
+
+void header_write_checked_layout(benchmark::state& state)
+{
+    write_layout<checked_header_layout>(state);
+}
+BENCHMARK(header_write_checked_layout);
+}
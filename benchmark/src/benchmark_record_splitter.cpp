@@ -0,0 +1,70 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/record_splitter.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t record_count = 4096;
+const uint64_t record_fields = 64;
+const uint64_t record_size = 2 + record_fields * 4;
+
+// Splits and decodes records of 64 4-byte fields with a given number of
+// threads, 0 being the number of hardware threads.
+template<uint32_t Threads>
+void parse_records(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer;
+    for (uint64_t i = 0; i < record_count; ++i)
+    {
+        buffer.insert(buffer.end(), {0x01, 0x00});
+        buffer.insert(buffer.end(), record_fields * 4, 0xAB);
+    }
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        auto records = bnb::split_records<2>(reader);
+        uint64_t sum = 0;
+        bnb::parse_records<endian::big_endian>(records,
+            [](bnb::stream_reader<endian::big_endian>& record)
+            {
+                uint64_t record_sum = 0;
+                for (uint64_t i = 0; i < record_fields; ++i)
+                {
+                    uint32_t value = 0;
+                    record.read_bytes<4>(value).expect_ne(0);
+                    record_sum += value;
+                }
+                return record_sum;
+            },
+            [&sum](uint64_t, uint64_t record_sum, const std::error_code&)
+            {
+                sum += record_sum;
+            },
+            Threads);
+
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(
+        state.iterations() * record_count * record_fields);
+    state.set_bytes_processed(
+        state.iterations() * record_count * record_size);
+}
+
+BENCHMARK(parse_records<1>);
+BENCHMARK(parse_records<0>);
+}
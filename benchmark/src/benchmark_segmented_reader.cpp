@@ -0,0 +1,57 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/segmented_reader.hpp>
+#include <endian/big_endian.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+// Reads 4 byte fields from a buffer split into segments of a given size.
+// Segment sizes which are not a multiple of 4 make fields cross segments.
+template<uint64_t SegmentSize>
+void segmented_read_bytes(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    std::vector<bnb::segment> segments;
+    for (uint64_t offset = 0; offset < buffer.size(); offset += SegmentSize)
+    {
+        segments.push_back({buffer.data() + offset,
+                            std::min(SegmentSize, buffer.size() - offset)});
+    }
+    const uint64_t fields = buffer.size() / 4;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::segmented_reader<endian::big_endian> reader(
+            segments.data(), segments.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < fields; ++i)
+        {
+            uint32_t value = 0;
+            reader.read_bytes<4>(value);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(segmented_read_bytes<1500>);
+BENCHMARK(segmented_read_bytes<64>);
+BENCHMARK(segmented_read_bytes<6>);
+}
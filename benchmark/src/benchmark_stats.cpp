@@ -0,0 +1,52 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stats.hpp>
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+// Reads and validates 4 byte fields with a given stats policy, to measure
+// the cost of the counters compared to no_stats.
+template<class Stats>
+void read_bytes_stats(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const uint64_t fields = buffer.size() / 4;
+    Stats stats;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian, bnb::no_diagnostics, Stats>
+            reader(buffer.data(), buffer.size(), error, stats);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < fields; ++i)
+        {
+            uint64_t value = 0;
+            reader.template read_bytes<4>(value).expect_ne(0);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(read_bytes_stats<bnb::no_stats>);
+BENCHMARK(read_bytes_stats<bnb::reader_stats>);
+BENCHMARK(read_bytes_stats<bnb::thread_stats>);
+}
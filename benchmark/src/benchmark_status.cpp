@@ -0,0 +1,56 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/status.hpp>
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+struct record
+{
+    int32_t id;
+    int32_t length;
+};
+
+// Reads and validates records into an array of ints with a given error
+// state. The stores to the records may alias a std::error_code, but not a
+// status.
+template<class Error>
+void read_records_error_state(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0x2B);
+    std::vector<record> records(buffer.size() / 8);
+
+    while (state.keep_running())
+    {
+        Error error;
+        bnb::stream_reader<endian::big_endian, bnb::no_diagnostics,
+                           bnb::no_stats, Error>
+            reader(buffer.data(), buffer.size(), error);
+
+        for (auto& r : records)
+        {
+            reader.template read_bytes<4>(r.id).expect_ne(0);
+            reader.template read_bytes<4>(r.length).expect_ge(0);
+        }
+        benchmark::do_not_optimize(records.data());
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * records.size() * 2);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(read_records_error_state<std::error_code>);
+BENCHMARK(read_records_error_state<bnb::status>);
+}
@@ -0,0 +1,234 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+template<class Endianness, uint8_t Bytes>
+void read_bytes(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const uint64_t fields = buffer.size() / Bytes;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<Endianness> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < fields; ++i)
+        {
+            uint64_t value = 0;
+            reader.template read_bytes<Bytes>(value);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * fields * Bytes);
+}
+
+BENCHMARK(read_bytes<endian::big_endian, 1>);
+BENCHMARK(read_bytes<endian::big_endian, 2>);
+BENCHMARK(read_bytes<endian::big_endian, 3>);
+BENCHMARK(read_bytes<endian::big_endian, 4>);
+BENCHMARK(read_bytes<endian::big_endian, 5>);
+BENCHMARK(read_bytes<endian::big_endian, 6>);
+BENCHMARK(read_bytes<endian::big_endian, 7>);
+BENCHMARK(read_bytes<endian::big_endian, 8>);
+BENCHMARK(read_bytes<endian::little_endian, 1>);
+BENCHMARK(read_bytes<endian::little_endian, 2>);
+BENCHMARK(read_bytes<endian::little_endian, 3>);
+BENCHMARK(read_bytes<endian::little_endian, 4>);
+BENCHMARK(read_bytes<endian::little_endian, 5>);
+BENCHMARK(read_bytes<endian::little_endian, 6>);
+BENCHMARK(read_bytes<endian::little_endian, 7>);
+BENCHMARK(read_bytes<endian::little_endian, 8>);
+
+template<class Endianness, uint8_t Bytes>
+void peek_bytes(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const uint64_t fields = buffer.size() / Bytes;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<Endianness> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < fields; ++i)
+        {
+            uint64_t value = 0;
+            reader.template peek_bytes<Bytes>(value, i * Bytes);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * fields * Bytes);
+}
+
+BENCHMARK(peek_bytes<endian::big_endian, 1>);
+BENCHMARK(peek_bytes<endian::big_endian, 4>);
+BENCHMARK(peek_bytes<endian::big_endian, 8>);
+BENCHMARK(peek_bytes<endian::little_endian, 1>);
+BENCHMARK(peek_bytes<endian::little_endian, 4>);
+BENCHMARK(peek_bytes<endian::little_endian, 8>);
+
+template<class BitNumbering>
+void read_bits(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0xAB);
+    const uint64_t reads = buffer.size() / bitter::u32::size;
+    const uint64_t fields_per_read = 4;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < reads; ++i)
+        {
+            uint8_t a = 0;
+            uint8_t b = 0;
+            uint16_t c = 0;
+            uint8_t d = 0;
+            reader.read_bits<bitter::u32, BitNumbering, 1, 7, 16, 8>()
+            .template get<0>(a)
+            .template get<1>(b)
+            .template get<2>(c)
+            .template get<3>(d);
+            sum += a + b + c + d;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * reads * fields_per_read);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(read_bits<bitter::msb0>);
+BENCHMARK(read_bits<bitter::lsb0>);
+
+template<class Format>
+void read_varint(benchmark::state& state)
+{
+    // Two byte encodings of 300 in both formats
+    std::vector<uint8_t> buffer;
+    for (uint64_t i = 0; i < buffer_size / 2; ++i)
+    {
+        if (std::is_same<Format, bnb::leb128>::value)
+            buffer.insert(buffer.end(), {0xAC, 0x02});
+        else
+            buffer.insert(buffer.end(), {0x41, 0x2C});
+    }
+    const uint64_t fields = buffer.size() / 2;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < fields; ++i)
+        {
+            uint64_t value = 0;
+            reader.template read_varint<Format>(value);
+            sum += value;
+        }
+        benchmark::do_not_optimize(sum);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(read_varint<bnb::leb128>);
+BENCHMARK(read_varint<bnb::quic_varint>);
+
+// The data to scan for a start code, which is only at the end. The data has
+// zero bytes, as video payloads do, so finding a zero byte isn't enough.
+std::vector<uint8_t> start_code_buffer()
+{
+    std::vector<uint8_t> buffer(64 * 1024);
+    for (uint64_t i = 0; i < buffer.size(); ++i)
+        buffer[i] = i % 7 == 0 ? 0x00 : 0xAB;
+    buffer.insert(buffer.end(), {0x00, 0x00, 0x01, 0x09});
+    return buffer;
+}
+
+// Scans for the start code with a peek per byte
+void find_start_code_peek(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer = start_code_buffer();
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t offset = 0;
+        while (offset + 3 <= reader.remaining_size())
+        {
+            uint32_t code = 0;
+            reader.peek_bytes<3>(code, offset);
+            if (code == 0x000001)
+                break;
+            ++offset;
+        }
+        reader.skip(offset);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(find_start_code_peek);
+
+// Scans for the start code with seek_to_start_code()
+void find_start_code_seek_to(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer = start_code_buffer();
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        bool found = reader.seek_to_start_code();
+        benchmark::do_not_optimize(found);
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(find_start_code_seek_to);
+}
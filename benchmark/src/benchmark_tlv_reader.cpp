@@ -0,0 +1,84 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stream_reader.hpp>
+#include <bnb/tlv_reader.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+// Looks up the last of a block of options with 1 byte types and lengths,
+// as when only one tag of an extension block is needed.
+namespace
+{
+const uint64_t options = 32;
+const uint64_t option_size = 2 + 16;
+
+std::vector<uint8_t> make_options()
+{
+    std::vector<uint8_t> buffer;
+    for (uint64_t i = 0; i < options; ++i)
+    {
+        buffer.insert(buffer.end(), {(uint8_t)i, 16});
+        buffer.insert(buffer.end(), 16, (uint8_t)i);
+    }
+    return buffer;
+}
+
+void set_processed(benchmark::state& state)
+{
+    state.set_items_processed(state.iterations() * options);
+    state.set_bytes_processed(state.iterations() * options * option_size);
+}
+
+// Walks the options eagerly, copying each value
+void tlv_copy_values(benchmark::state& state)
+{
+    auto buffer = make_options();
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        std::vector<std::vector<uint8_t>> values(options);
+        while (!reader.error() && reader.remaining_size() > 0)
+        {
+            uint8_t type = 0;
+            uint8_t length = 0;
+            reader.read_bytes<1>(type);
+            reader.read_bytes<1>(length);
+            values[type].resize(length);
+            reader.read(values[type].data(), length);
+        }
+        benchmark::do_not_optimize(values[options - 1][0]);
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+BENCHMARK(tlv_copy_values);
+
+void tlv_reader_find(benchmark::state& state)
+{
+    auto buffer = make_options();
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+        bnb::tlv_reader<1, 1, decltype(reader)> entries(reader);
+
+        bnb::tlv_entry entry;
+        entries.find(options - 1, entry);
+        benchmark::do_not_optimize(entry.value[0]);
+        benchmark::do_not_optimize(error);
+    }
+    set_processed(state);
+}
+BENCHMARK(tlv_reader_find);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../benchmark.hpp"
+
+namespace
+{
+const uint64_t buffer_size = 4096;
+
+template<class Validate>
+void validate(benchmark::state& state, Validate validate)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0x2A);
+    const uint64_t fields = buffer.size() / 2;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        for (uint64_t i = 0; i < fields; ++i)
+            validate(reader.read_bytes<2>());
+
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * fields);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+
+void expect_comparisons(benchmark::state& state)
+{
+    validate(state, [](bnb::validator<uint64_t> validator)
+    {
+        validator.expect_ne(0).expect_gt(1).expect_lt(0xFFFF).expect_le(0x2A2A);
+    });
+}
+BENCHMARK(expect_comparisons);
+
+void expect_constants(benchmark::state& state)
+{
+    validate(state, [](bnb::validator<uint64_t> validator)
+    {
+        validator.expect_ne<0>().expect_in_range<2, 0x2A2A>();
+    });
+}
+BENCHMARK(expect_constants);
+
+void expect_predicate(benchmark::state& state)
+{
+    uint64_t limit = 0x2A2A;
+    validate(state, [limit](bnb::validator<uint64_t> validator)
+    {
+        validator.expect([limit](uint64_t value) { return value <= limit; });
+    });
+}
+BENCHMARK(expect_predicate);
+
+void expect_std_function(benchmark::state& state)
+{
+    uint64_t limit = 0x2A2A;
+    std::function<bool(uint64_t)> predicate = [limit](uint64_t value)
+    {
+        return value <= limit;
+    };
+    validate(state, [&predicate](bnb::validator<uint64_t> validator)
+    {
+        validator.expect(predicate);
+    });
+}
+BENCHMARK(expect_std_function);
+
+void bit_reader_chain(benchmark::state& state)
+{
+    std::vector<uint8_t> buffer(buffer_size, 0x2A);
+    const uint64_t reads = buffer.size() / bitter::u64::size;
+    const uint64_t fields_per_read = 8;
+
+    while (state.keep_running())
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        for (uint64_t i = 0; i < reads; ++i)
+        {
+            reader.read_bits<bitter::u64, bitter::msb0,
+                             8, 8, 8, 8, 8, 8, 8, 8>()
+            .get<0>().expect_eq(0x2A).get<1>().expect_eq(0x2A)
+            .get<2>().expect_eq(0x2A).get<3>().expect_eq(0x2A)
+            .get<4>().expect_eq(0x2A).get<5>().expect_eq(0x2A)
+            .get<6>().expect_eq(0x2A).get<7>().expect_eq(0x2A);
+        }
+        benchmark::do_not_optimize(error);
+    }
+
+    state.set_items_processed(state.iterations() * reads * fields_per_read);
+    state.set_bytes_processed(state.iterations() * buffer.size());
+}
+BENCHMARK(bit_reader_chain);
+}
@@ -0,0 +1,141 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <system_error>
+
+// Fuzz target for the stream reader. The first half of the input selects a
+// sequence of operations and their arguments, the second half is the buffer
+// being read. Every access must stay within the buffer, which is checked by
+// building with -fsanitize=fuzzer,address.
+
+namespace
+{
+// Consumes the operation bytes of the input
+struct operations
+{
+    uint8_t next()
+    {
+        return m_size == 0 ? 0 : (--m_size, *m_data++);
+    }
+
+    uint64_t next_u64()
+    {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < 8; ++i)
+            value = (value << 8) | next();
+        return value;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+};
+
+template<class Reader>
+void fuzz_reader(Reader& reader, std::error_code& error, operations& ops,
+                 uint32_t depth)
+{
+    uint8_t buffer[256];
+
+    while (!ops.empty())
+    {
+        switch (ops.next() % 17)
+        {
+        case 0: reader.template read_bytes<1>(); break;
+        case 1: reader.template read_bytes<2>(); break;
+        case 2: reader.template read_bytes<4>(); break;
+        case 3: reader.template read_bytes<8>(); break;
+        case 4: reader.template peek_bytes<4>(ops.next()); break;
+        case 5: reader.template peek_bytes<8>(ops.next_u64()); break;
+        case 6: reader.read(buffer, ops.next()); break;
+        case 7: reader.seek(ops.next_u64() % 512); break;
+        case 8:
+        {
+            uint64_t values[32];
+            reader.template read_array<4>(values, ops.next() % 32);
+            reader.template peek_array<8>(values, ops.next() % 32,
+                                          ops.next_u64());
+            break;
+        }
+        case 9:
+            reader.template read_varint<bnb::leb128>();
+            reader.template read_varint<bnb::quic_varint>();
+            break;
+        case 10:
+        {
+            auto bytes = reader.read_view(ops.next());
+            for (uint8_t byte : bytes)
+                buffer[byte] = byte;
+            break;
+        }
+        case 11:
+            reader.template read_bits<bitter::u16, bitter::msb0, 3, 9, 4>()
+                .template get<0>().template get<1>().template get<2>();
+            break;
+        case 12:
+        {
+            auto window = reader.require(ops.next() % 16);
+            if (!reader.error() && window.size() >= 8)
+            {
+                window.template read_bytes<4>();
+                window.template peek_bytes<4>();
+            }
+
+            // The runtime offsets and sizes are checked against the window
+            window.template peek_bytes<2>(ops.next_u64());
+            auto skipped = window.skip(ops.next());
+            if (!reader.error() && skipped.size() >= 1)
+                skipped.template read_bytes<1>();
+            if (!reader.error() && window.remaining_size() > window.size())
+                std::abort();
+            break;
+        }
+        case 13:
+        {
+            auto sub_reader = reader.skip(ops.next());
+            if (depth < 4)
+                fuzz_reader(sub_reader, error, ops, depth + 1);
+            break;
+        }
+        case 14: reader.template read_length_prefixed<1>(); break;
+        case 15:
+        {
+            buffer[0] = ops.next();
+            buffer[1] = ops.next();
+            reader.seek_to(buffer, ops.next() % 3);
+            reader.seek_to_start_code();
+            break;
+        }
+        default:
+            // Clear the error to keep exploring after a failed access
+            error.clear();
+            break;
+        }
+
+        if (!error && reader.position() > reader.size())
+            std::abort();
+    }
+}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    operations ops{data, size / 2};
+
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        data + size / 2, size - size / 2, error);
+    fuzz_reader(reader, error, ops, 0);
+    return 0;
+}
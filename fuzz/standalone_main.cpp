@@ -0,0 +1,49 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// Runs a fuzz target without libFuzzer, e.g. for compilers which don't
+// support -fsanitize=fuzzer. Replays the inputs given as arguments, or runs
+// a number of random inputs if none are given.
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::ifstream file(argv[i], std::ios::binary);
+            if (!file)
+            {
+                std::fprintf(stderr, "Could not open %s\n", argv[i]);
+                return 1;
+            }
+            std::vector<uint8_t> input(
+                (std::istreambuf_iterator<char>(file)),
+                std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(input.data(), input.size());
+        }
+        return 0;
+    }
+
+    std::mt19937 random(0);
+    for (uint32_t run = 0; run < 100000; ++run)
+    {
+        std::vector<uint8_t> input(random() % 512);
+        for (auto& byte : input)
+            byte = (uint8_t)random();
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#include "error.hpp"
+#include "status.hpp"
+
+namespace bnb
+{
+/// Validator of every element in an array of decoded values, see
+/// stream_reader::read_array(). The Error is the type of the error state,
+/// std::error_code or status.
+template<class ValueType, class Error = std::error_code>
+class array_validator
+{
+public:
+
+    /// Constructs an array validator.
+    /// @param values Pointer to the values to check
+    /// @param count The number of values
+    /// @param error The error code to set if the validation failed
+    array_validator(const ValueType* values, uint64_t count,
+                    Error& error) :
+        m_values(values),
+        m_count(count),
+        m_error(error)
+    { }
+
+    /// Checks if every value is less than the expected value.
+    /// @param expected_value The expected value
+    /// @returns A reference to this object, so that more expectations
+    ///          can be made.
+    array_validator& expect_lt(ValueType expected_value)
+    {
+        return check(bnb::error::value_out_of_range,
+                     [expected_value](ValueType value)
+        {
+            return value < expected_value;
+        });
+    }
+
+    /// Checks if every value is less than or equal to the expected value.
+    /// @param expected_value The expected value
+    /// @returns A reference to this object, so that more expectations
+    ///          can be made.
+    array_validator& expect_le(ValueType expected_value)
+    {
+        return check(bnb::error::value_out_of_range,
+                     [expected_value](ValueType value)
+        {
+            return value <= expected_value;
+        });
+    }
+
+    /// Checks if every value is greater than the expected value.
+    /// @param expected_value The expected value
+    /// @returns A reference to this object, so that more expectations
+    ///          can be made.
+    array_validator& expect_gt(ValueType expected_value)
+    {
+        return check(bnb::error::value_out_of_range,
+                     [expected_value](ValueType value)
+        {
+            return value > expected_value;
+        });
+    }
+
+    /// Checks if every value is greater than or equal to the expected value.
+    /// @param expected_value The expected value
+    /// @returns A reference to this object, so that more expectations
+    ///          can be made.
+    array_validator& expect_ge(ValueType expected_value)
+    {
+        return check(bnb::error::value_out_of_range,
+                     [expected_value](ValueType value)
+        {
+            return value >= expected_value;
+        });
+    }
+
+    /// Checks if every value makes the given predicate return true.
+    /// @param predicate The predicate called with each value
+    /// @returns A reference to this object, so that more expectations
+    ///          can be made.
+    template<class Predicate>
+    array_validator& expect(Predicate&& predicate)
+    {
+        return check(bnb::error::predicate_failed,
+                     std::forward<Predicate>(predicate));
+    }
+
+private:
+
+    /// Sets the error code if any value makes the predicate return false
+    template<class Predicate>
+    array_validator& check(bnb::error error, Predicate&& predicate)
+    {
+        if (m_error)
+            return *this;
+
+        bool valid = true;
+        for (uint64_t i = 0; i < m_count; ++i)
+            valid &= static_cast<bool>(predicate(m_values[i]));
+
+        if (!valid)
+            detail::set_error(m_error, error);
+
+        return *this;
+    }
+
+    const ValueType* m_values;
+    uint64_t m_count;
+    Error& m_error;
+};
+}
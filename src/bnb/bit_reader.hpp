@@ -7,22 +7,93 @@
 
 #include <cstdint>
 #include <system_error>
+#include <utility>
 #include <bitter/reader.hpp>
 #include <bitter/msb0.hpp>
 #include <bitter/lsb0.hpp>
 
+#include "reader_context.hpp"
 #include "validator_wrapper.hpp"
 
 namespace bnb
 {
-template<class Type, class BitNumbering, uint32_t... Sizes>
-class bit_reader
+namespace detail
+{
+/// Forwards the get calls of a validator_wrapper to the bit reader it was
+/// created by. This way only a reference to the bit reader is copied into
+/// the wrapper when chaining the calls.
+///
+/// Note, the bit reader must outlive the returned wrappers. It is therefore
+/// only used for bit readers which are lvalues, the wrappers created by a
+/// temporary bit reader hold a copy of it instead.
+template<class BitReader>
+class bit_reader_reference
+{
+public:
+
+    /// Constructs a reference to a bit reader
+    /// @param reader The bit reader to forward to
+    bit_reader_reference(BitReader& reader) :
+        m_reader(reader)
+    { }
+
+    /// Forwards to BitReader::get()
+    template<uint32_t Index, class ValueType>
+    auto get(ValueType& value) const
+    {
+        return m_reader.template get<Index, ValueType>(value);
+    }
+
+    /// Forwards to BitReader::get()
+    template<uint32_t Index>
+    auto get() const
+    {
+        return m_reader.template get<Index>();
+    }
+
+private:
+
+    BitReader& m_reader;
+};
+
+/// The number of bits before the field at Index, i.e. the sum of the sizes of
+/// the preceding fields
+template<uint32_t Index, uint32_t... Sizes>
+struct bit_offset;
+
+template<uint32_t Size, uint32_t... Sizes>
+struct bit_offset<0, Size, Sizes...>
+{
+    enum { value = 0 };
+};
+
+template<uint32_t Index, uint32_t Size, uint32_t... Sizes>
+struct bit_offset<Index, Size, Sizes...>
+{
+    enum { value = Size + bit_offset<Index - 1, Sizes...>::value };
+};
+}
+
+/// Reads bit fields from a value, see bit_reader. The Context is the
+/// diagnostics and stats state of the reader which read the value, see
+/// stream_reader.
+template<class Context, class Type, class BitNumbering, uint32_t... Sizes>
+class basic_bit_reader
 {
 private:
 
     /// The internal bitter reader type
     using reader_type = bitter::reader<Type, BitNumbering, Sizes...>;
 
+    /// The reference to this bit reader which is wrapped by the validators
+    using reference_type = detail::bit_reader_reference<basic_bit_reader>;
+
+    /// The diagnostics and stats state of the value
+    using context_type = Context;
+
+    /// The error state, std::error_code or status
+    using error_type = typename Context::error_type;
+
 public:
 
     /// The data type used as storage for this bit reader.
@@ -33,9 +104,12 @@ public:
     /// Constructs a bit reader
     /// @param value The value to serve as the data for this bit reader
     /// @param error The error code to set upon error
-    bit_reader(value_type value, std::error_code& error) :
+    /// @param context Where to report failed validations
+    basic_bit_reader(value_type value, error_type& error,
+                     const context_type& context = context_type()) :
         m_reader(value),
-        m_error(error)
+        m_error(error),
+        m_context(context)
     { }
 
     /// Reads a given value at a given index
@@ -45,12 +119,25 @@ public:
     ///         This allows for the next values to be read and for the current
     ///         value to be validated if needed.
     template<uint32_t Index, class ValueType>
-    validator_wrapper<bit_reader, ValueType> get(ValueType& value)
+    validator_wrapper<reference_type, ValueType, Context> get(
+        ValueType& value) &
     {
-        if (m_error)
-            return { *this, value, m_error };
-        value = m_reader.template field<Index>().template as<ValueType>();
-        return { *this, value, m_error };
+        auto context = read<Index>(value);
+        return { reference_type(*this), value, m_error, context };
+    }
+
+    /// Reads a given value at a given index of a temporary bit reader, e.g.
+    /// the one returned by stream_reader::read_bits().
+    /// @param value The destination for the read value. Nothing will be read
+    ///              if the error code has been set.
+    /// @return A copy of this object wrapped in a validator object, so the
+    ///         validator can be stored and used after this object is gone.
+    template<uint32_t Index, class ValueType>
+    validator_wrapper<basic_bit_reader, ValueType, Context> get(
+        ValueType& value) &&
+    {
+        auto context = read<Index>(value);
+        return { *this, value, m_error, context };
     }
 
     /// Reads value at a given index without storage the value
@@ -58,15 +145,49 @@ public:
     ///         This allows for the next values to be read and for the current
     ///         value to be validated if needed.
     template<uint32_t Index>
-    auto get()
+    auto get() &
     {
         value_type value = 0;
         return get<Index, value_type>(value);
     }
 
+    /// Reads value at a given index of a temporary bit reader without
+    /// storing the value
+    /// @return A copy of this object wrapped in a validator object.
+    template<uint32_t Index>
+    auto get() &&
+    {
+        value_type value = 0;
+        return std::move(*this).template get<Index, value_type>(value);
+    }
+
+private:
+
+    /// Reads the value at a given index unless the error code has been set
+    /// @param value The destination for the read value
+    /// @return The context of the value
+    template<uint32_t Index, class ValueType>
+    context_type read(ValueType& value)
+    {
+        auto context = m_context.at(
+            m_context.position(), detail::bit_offset<Index, Sizes...>::value);
+
+        if (m_error)
+            return context;
+        value = m_reader.template field<Index>().template as<ValueType>();
+        m_context.count_field();
+        return context;
+    }
+
 private:
 
     reader_type m_reader;
-    std::error_code& m_error;
+    error_type& m_error;
+    context_type m_context;
 };
+
+/// Reads bit fields from a value
+template<class Type, class BitNumbering, uint32_t... Sizes>
+using bit_reader =
+    basic_bit_reader<detail::reader_context<>, Type, BitNumbering, Sizes...>;
 }
@@ -0,0 +1,746 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <cassert>
+#include <type_traits>
+#include <bitter/msb0.hpp>
+#include <bitter/lsb0.hpp>
+
+#include "bit_utility.hpp"
+#include "error.hpp"
+#include "validator.hpp"
+#include "view.hpp"
+
+namespace bnb
+{
+namespace detail
+{
+/// @return True if any of the 8 bytes of the word is zero
+inline bool has_zero_byte(uint64_t word)
+{
+    return ((word - 0x0101010101010101ULL) & ~word &
+            0x8080808080808080ULL) != 0;
+}
+
+/// The bit order of a bit stream. The buffer keeps the next bit of the
+/// stream at the most significant end for msb0 and at the least significant
+/// end for lsb0.
+template<class BitNumbering>
+struct bit_stream_order;
+
+/// The first bit of the stream is the most significant bit of the first
+/// byte, e.g. as in H.264 and MPEG.
+template<>
+struct bit_stream_order<bitter::msb0>
+{
+    static uint64_t load(const uint8_t* data)
+    {
+        return load_big_endian_u64(data);
+    }
+
+    /// @return The bits at position count in the buffer
+    static uint64_t place(uint64_t bits, uint32_t count)
+    {
+        return bits >> count;
+    }
+
+    /// @return The byte placed at position count in the buffer
+    static uint64_t place_byte(uint8_t byte, uint32_t count)
+    {
+        return (uint64_t)byte << (56 - count);
+    }
+
+    /// @return The next bits of the buffer, where 0 < bits < 64
+    static uint64_t get(uint64_t buffer, uint32_t bits)
+    {
+        return buffer >> (64 - bits);
+    }
+
+    /// @return The buffer without the next bits, where bits < 64
+    static uint64_t consume(uint64_t buffer, uint32_t bits)
+    {
+        return buffer << bits;
+    }
+
+    /// @return The value of a field read in two parts, where the first
+    ///         part is 32 bits
+    static uint64_t combine(uint64_t first, uint64_t second,
+                            uint32_t second_bits)
+    {
+        return (first << second_bits) | second;
+    }
+
+    /// @return The number of zero bits before the first one bit of the
+    ///         buffer, or 64 if there is none
+    static uint32_t zero_run(uint64_t buffer)
+    {
+        return buffer == 0 ? 64 : count_leading_zeros(buffer);
+    }
+};
+
+/// The first bit of the stream is the least significant bit of the first
+/// byte, e.g. as in DEFLATE.
+template<>
+struct bit_stream_order<bitter::lsb0>
+{
+    static uint64_t load(const uint8_t* data)
+    {
+        return load_little_endian_u64(data);
+    }
+
+    static uint64_t place(uint64_t bits, uint32_t count)
+    {
+        return bits << count;
+    }
+
+    static uint64_t place_byte(uint8_t byte, uint32_t count)
+    {
+        return (uint64_t)byte << count;
+    }
+
+    static uint64_t get(uint64_t buffer, uint32_t bits)
+    {
+        return buffer & ((uint64_t(1) << bits) - 1);
+    }
+
+    static uint64_t consume(uint64_t buffer, uint32_t bits)
+    {
+        return buffer >> bits;
+    }
+
+    static uint64_t combine(uint64_t first, uint64_t second, uint32_t)
+    {
+        return (second << 32) | first;
+    }
+
+    static uint32_t zero_run(uint64_t buffer)
+    {
+        return buffer == 0 ? 64 : count_trailing_zeros(buffer);
+    }
+};
+}
+
+/// The default filter of a bit_stream_reader, which reads every byte.
+struct no_filter
+{
+    /// Whether the filter may remove bytes
+    enum { removes_bytes = false };
+
+    /// @param word The next 8 bytes
+    /// @return True if none of the bytes would be removed
+    bool accept_word(uint64_t word)
+    {
+        (void)word;
+        return true;
+    }
+
+    /// @param byte The next byte
+    /// @return True if the byte is part of the stream
+    bool accept(uint8_t byte)
+    {
+        (void)byte;
+        return true;
+    }
+};
+
+/// A filter of a bit_stream_reader which removes the emulation prevention
+/// bytes of H.264 and H.265 NAL units, i.e. the 0x03 in 0x000003, so the
+/// payload can be parsed in place.
+struct emulation_prevention
+{
+    enum { removes_bytes = true };
+
+    bool accept_word(uint64_t word)
+    {
+        // Without zero bytes there can be no 0x000003 in the word
+        if (m_zeros >= 2 || detail::has_zero_byte(word))
+            return false;
+
+        m_zeros = 0;
+        return true;
+    }
+
+    bool accept(uint8_t byte)
+    {
+        if (m_zeros >= 2 && byte == 0x03)
+        {
+            m_zeros = 0;
+            return false;
+        }
+
+        m_zeros = byte == 0 ? m_zeros + 1 : 0;
+        return true;
+    }
+
+    /// The number of zero bytes just before the next byte
+    uint32_t m_zeros = 0;
+};
+
+/// Reads fields of 1 to 64 bits back-to-back from a buffer, without
+/// requiring the fields to start on a byte boundary.
+///
+/// The bits are read through a 64-bit buffer, which is refilled with a
+/// single unaligned load whenever 8 bytes remain, so reading a field is a
+/// bounds check, a shift and a mask.
+///
+/// @tparam BitNumbering The bit order of the stream, bitter::msb0 or
+///         bitter::lsb0
+/// @tparam Filter Removes bytes from the stream while reading, e.g.
+///         emulation_prevention
+template<class BitNumbering, class Filter = no_filter>
+class bit_stream_reader
+{
+private:
+
+    using order = detail::bit_stream_order<BitNumbering>;
+
+    /// The largest field which can always be read from a refilled buffer
+    enum { max_refill_bits = 56 };
+
+public:
+
+    /// Constructs a bit stream reader over a pre-allocated buffer.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the allocated data in bytes
+    /// @param error A reference to the error code to set if an error happened
+    bit_stream_reader(const uint8_t* data, uint64_t size,
+                      std::error_code& error) :
+        m_data(data),
+        m_size(size),
+        m_error(error)
+    { }
+
+    /// Constructs a bit stream reader over a view, e.g. returned by
+    /// stream_reader::read_view().
+    ///
+    /// @param bytes The bytes to read
+    /// @param error A reference to the error code to set if an error happened
+    bit_stream_reader(const view& bytes, std::error_code& error) :
+        bit_stream_reader(bytes.data(), bytes.size(), error)
+    { }
+
+    /// Reads a field of Bits bits and moves the bit position.
+    ///
+    /// @param value reference to the value to be read.
+    template<uint32_t Bits, class ValueType>
+    validator<ValueType> read_bits(ValueType& value)
+    {
+        static_assert(Bits > 0 && Bits <= 64, "Bits must be from 1 to 64");
+        static_assert(Bits <= sizeof(ValueType) * 8,
+                      "The ValueType is too small for the field");
+
+        if (m_error)
+            return { value, m_error };
+
+        uint64_t field = 0;
+        if (get(Bits, field))
+            value = (ValueType)field;
+        return { value, m_error };
+    }
+
+    /// Reads a field of Bits bits and moves the bit position.
+    template<uint32_t Bits>
+    validator<uint64_t> read_bits()
+    {
+        uint64_t value = 0;
+        return read_bits<Bits, uint64_t>(value);
+    }
+
+    /// Reads a field with a width only known at runtime and moves the bit
+    /// position.
+    ///
+    /// @param value reference to the value to be read.
+    /// @param bits The width of the field from 1 to the bits of the
+    ///        ValueType. Other widths set bnb::error::invalid_size.
+    template<class ValueType>
+    validator<ValueType> read_bits(ValueType& value, uint32_t bits)
+    {
+        if (m_error)
+            return { value, m_error };
+
+        if (bits == 0 || bits > sizeof(ValueType) * 8 || bits > 64)
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_size);
+            return { value, m_error };
+        }
+
+        uint64_t field = 0;
+        if (get(bits, field))
+            value = (ValueType)field;
+        return { value, m_error };
+    }
+
+    /// Peeks a field without moving the bit position.
+    ///
+    /// @param value reference to the value to be read.
+    /// @param bits The width of the field from 1 to 56, and at most the bits
+    ///        of the ValueType. Other widths set bnb::error::invalid_size.
+    template<class ValueType>
+    validator<ValueType> peek_bits(ValueType& value, uint32_t bits)
+    {
+        if (m_error)
+            return { value, m_error };
+
+        if (bits == 0 || bits > sizeof(ValueType) * 8 ||
+            bits > max_refill_bits)
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_size);
+            return { value, m_error };
+        }
+
+        if (!available(bits))
+            return { value, m_error };
+
+        value = (ValueType)order::get(m_buffer, bits);
+        return { value, m_error };
+    }
+
+    /// Reads a unary coded value, i.e. the number of bits before a stop
+    /// bit, and moves the bit position past the stop bit.
+    ///
+    /// @param value reference to the value to be read.
+    /// @tparam StopBit The bit ending the value, 1 for runs of zeros and 0
+    ///         for runs of ones
+    template<uint32_t StopBit, class ValueType>
+    validator<ValueType> read_unary(ValueType& value)
+    {
+        static_assert(StopBit <= 1, "The stop bit must be 0 or 1");
+
+        if (m_error)
+            return { value, m_error };
+
+        uint64_t run = 0;
+        if (!get_run<StopBit>(UINT64_MAX, run))
+            return { value, m_error };
+
+        if (run != (uint64_t)(ValueType)run)
+        {
+            m_error = bnb::make_error_code(bnb::error::value_too_large);
+            return { value, m_error };
+        }
+
+        value = (ValueType)run;
+        return { value, m_error };
+    }
+
+    /// Reads a unary coded value and moves the bit position.
+    template<uint32_t StopBit>
+    validator<uint64_t> read_unary()
+    {
+        uint64_t value = 0;
+        return read_unary<StopBit, uint64_t>(value);
+    }
+
+    /// Reads an unsigned Exp-Golomb coded value, i.e. ue(v) of H.264 and
+    /// H.265, and moves the bit position.
+    ///
+    /// The error code is set if the prefix is longer than 63 bits, or if the
+    /// value doesn't fit in the ValueType.
+    ///
+    /// @param value reference to the value to be read.
+    template<class ValueType>
+    validator<ValueType> read_exp_golomb(ValueType& value)
+    {
+        if (m_error)
+            return { value, m_error };
+
+        uint64_t code = 0;
+        if (!get_exp_golomb(code))
+            return { value, m_error };
+
+        if (code != (uint64_t)(ValueType)code)
+        {
+            m_error = bnb::make_error_code(bnb::error::value_too_large);
+            return { value, m_error };
+        }
+
+        value = (ValueType)code;
+        return { value, m_error };
+    }
+
+    /// Reads an unsigned Exp-Golomb coded value and moves the bit position.
+    validator<uint64_t> read_exp_golomb()
+    {
+        uint64_t value = 0;
+        return read_exp_golomb<uint64_t>(value);
+    }
+
+    /// Reads a signed Exp-Golomb coded value, i.e. se(v) of H.264 and H.265,
+    /// and moves the bit position. The codes 1, 2, 3, 4, ... map to the
+    /// values 1, -1, 2, -2, ...
+    ///
+    /// @param value reference to the value to be read.
+    template<class ValueType>
+    validator<ValueType> read_signed_exp_golomb(ValueType& value)
+    {
+        static_assert(std::is_signed<ValueType>::value,
+                      "The ValueType must be signed");
+
+        if (m_error)
+            return { value, m_error };
+
+        uint64_t code = 0;
+        if (!get_exp_golomb(code))
+            return { value, m_error };
+
+        int64_t decoded = (code & 1) ?
+            (int64_t)(code / 2 + 1) : -(int64_t)(code / 2);
+        if (decoded != (int64_t)(ValueType)decoded)
+        {
+            m_error = bnb::make_error_code(bnb::error::value_too_large);
+            return { value, m_error };
+        }
+
+        value = (ValueType)decoded;
+        return { value, m_error };
+    }
+
+    /// Reads a signed Exp-Golomb coded value and moves the bit position.
+    validator<int64_t> read_signed_exp_golomb()
+    {
+        int64_t value = 0;
+        return read_signed_exp_golomb<int64_t>(value);
+    }
+
+    /// Reads a truncated binary coded value, e.g. ns(n) of AV1, and moves
+    /// the bit position. Values below 2^(k+1) - symbols, where
+    /// k = floor(log2(symbols)), are coded in k bits, the rest in k + 1 bits.
+    ///
+    /// The error code is set if the value doesn't fit in the ValueType.
+    ///
+    /// @param value reference to the value to be read.
+    /// @param symbols The number of possible values, at least 1. Zero sets
+    ///        bnb::error::invalid_size.
+    template<class ValueType>
+    validator<ValueType> read_truncated_binary(ValueType& value,
+                                               uint64_t symbols)
+    {
+        if (m_error)
+            return { value, m_error };
+
+        if (symbols == 0)
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_size);
+            return { value, m_error };
+        }
+
+        uint32_t bits = 63 - detail::count_leading_zeros(symbols);
+        uint64_t short_codes = (uint64_t(2) << bits) - symbols;
+
+        uint64_t code = 0;
+        if (bits > 0 && !get(bits, code))
+            return { value, m_error };
+
+        if (code >= short_codes)
+        {
+            uint64_t extra = 0;
+            if (!get(1, extra))
+                return { value, m_error };
+            code = ((code << 1) | extra) - short_codes;
+        }
+
+        if (code != (uint64_t)(ValueType)code)
+        {
+            m_error = bnb::make_error_code(bnb::error::value_too_large);
+            return { value, m_error };
+        }
+
+        value = (ValueType)code;
+        return { value, m_error };
+    }
+
+    /// Reads a truncated binary coded value and moves the bit position.
+    validator<uint64_t> read_truncated_binary(uint64_t symbols)
+    {
+        uint64_t value = 0;
+        return read_truncated_binary<uint64_t>(value, symbols);
+    }
+
+    /// Skips a number of bits
+    ///
+    /// @param bits The number of bits to skip
+    void skip_bits(uint64_t bits)
+    {
+        if (m_error)
+            return;
+
+        if (bits <= m_count)
+        {
+            drop((uint32_t)bits);
+            return;
+        }
+
+        if (bits > remaining_bits())
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_seek);
+            return;
+        }
+
+        if (!Filter::removes_bytes)
+        {
+            seek_bits(bit_position() + bits);
+            return;
+        }
+
+        // The bytes removed are only known by reading them
+        while (bits > 0)
+        {
+            uint32_t part = bits < max_refill_bits ?
+                (uint32_t)bits : (uint32_t)max_refill_bits;
+            if (!available(part))
+            {
+                m_error = bnb::make_error_code(bnb::error::invalid_seek);
+                return;
+            }
+            drop(part);
+            bits -= part;
+        }
+    }
+
+    /// Skips to the next byte boundary, unless at one already
+    void align()
+    {
+        if (m_error)
+            return;
+
+        // The buffer is always filled with whole bytes
+        drop(m_count % 8);
+    }
+
+    /// @return True if the bit position is on a byte boundary
+    bool is_aligned() const
+    {
+        return m_count % 8 == 0;
+    }
+
+    /// @return The position in bits from the beginning of the stream, not
+    ///         counting bytes removed by the filter
+    uint64_t bit_position() const
+    {
+        return (m_next - m_removed) * 8 - m_count;
+    }
+
+    /// @return The position in bytes from the beginning of the stream,
+    ///         rounded up to include a partially read byte
+    uint64_t position() const
+    {
+        return (bit_position() + 7) / 8;
+    }
+
+    /// @return The remaining number of bits in the stream. If the filter
+    ///         removes bytes this is an upper bound, as the bytes not yet
+    ///         read may be removed.
+    uint64_t remaining_bits() const
+    {
+        return (m_size - m_next) * 8 + m_count;
+    }
+
+    /// @return The size of the underlying buffer in bytes
+    uint64_t size() const
+    {
+        return m_size;
+    }
+
+    /// @return The error code
+    std::error_code error() const
+    {
+        return m_error;
+    }
+
+private:
+
+    /// Makes sure the buffer holds at least a number of bits, otherwise sets
+    /// the error code.
+    ///
+    /// @param bits The number of bits from 1 to 56
+    /// @return True if the bits are available
+    bool available(uint32_t bits)
+    {
+        if (bits <= m_count)
+            return true;
+
+        refill();
+        if (bits <= m_count)
+            return true;
+
+        m_error = bnb::make_error_code(bnb::error::truncated);
+        return false;
+    }
+
+    /// Reads a field of 1 to 64 bits
+    /// @return True if the bits were available
+    bool get(uint32_t bits, uint64_t& value)
+    {
+        if (bits > max_refill_bits)
+        {
+            // The buffer may hold too few bits after a refill, so read the
+            // field in two parts
+            uint64_t first = 0;
+            uint64_t second = 0;
+            if (!get(32, first) || !get(bits - 32, second))
+                return false;
+
+            value = order::combine(first, second, bits - 32);
+            return true;
+        }
+
+        if (!available(bits))
+            return false;
+
+        value = order::get(m_buffer, bits);
+        drop(bits);
+        return true;
+    }
+
+    /// Reads a run of bits ended by the stop bit, using a count of leading
+    /// or trailing zeros instead of a loop per bit.
+    ///
+    /// @param max_run The longest run allowed, otherwise the error code is
+    ///        set
+    /// @param run The length of the run, not counting the stop bit
+    /// @return True if the run and the stop bit were read
+    template<uint32_t StopBit>
+    bool get_run(uint64_t max_run, uint64_t& run)
+    {
+        run = 0;
+        while (true)
+        {
+            if (m_count == 0)
+            {
+                refill();
+                if (m_count == 0)
+                {
+                    m_error = bnb::make_error_code(bnb::error::truncated);
+                    return false;
+                }
+            }
+
+            // The bits beyond m_count are not part of the run
+            uint32_t zeros = order::zero_run(StopBit ? m_buffer : ~m_buffer);
+            if (zeros < m_count)
+            {
+                run += zeros;
+                drop(zeros + 1);
+                break;
+            }
+
+            run += m_count;
+            drop(m_count);
+
+            if (run > max_run)
+                break;
+        }
+
+        if (run > max_run)
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_varint);
+            return false;
+        }
+        return true;
+    }
+
+    /// Reads an unsigned Exp-Golomb code, i.e. a run of zeros, a one and
+    /// as many bits as there were zeros
+    /// @return True if the code was read
+    bool get_exp_golomb(uint64_t& code)
+    {
+        // A prefix of 64 zeros would give a code beyond 64 bits
+        uint64_t zeros = 0;
+        if (!get_run<1>(63, zeros))
+            return false;
+
+        uint64_t suffix = 0;
+        if (zeros > 0 && !get((uint32_t)zeros, suffix))
+            return false;
+
+        code = ((uint64_t(1) << zeros) - 1) + suffix;
+        return true;
+    }
+
+    /// Removes bits from the buffer, where bits <= m_count
+    void drop(uint32_t bits)
+    {
+        assert(bits <= m_count);
+        m_buffer = bits < 64 ? order::consume(m_buffer, bits) : 0;
+        m_count -= bits;
+    }
+
+    /// Fills the buffer with at least 57 bits, or the rest of the stream.
+    ///
+    /// The bits beyond m_count in the buffer are either zero or the next
+    /// bits of the stream, so loading the same bytes again is harmless.
+    void refill()
+    {
+        if (m_size >= 8 && m_next <= m_size - 8)
+        {
+            uint64_t word = order::load(m_data + m_next);
+            if (m_filter.accept_word(word))
+            {
+                m_buffer |= order::place(word, m_count);
+                m_next += (63 - m_count) / 8;
+                m_count |= 56;
+                return;
+            }
+        }
+
+        while (m_count <= 56 && m_next < m_size)
+        {
+            uint8_t byte = m_data[m_next];
+            ++m_next;
+
+            if (!m_filter.accept(byte))
+            {
+                ++m_removed;
+                continue;
+            }
+
+            m_buffer |= order::place_byte(byte, m_count);
+            m_count += 8;
+        }
+    }
+
+    /// Moves to a bit position, which is known to be within the stream and
+    /// beyond the buffer. Only used without a filter removing bytes.
+    void seek_bits(uint64_t position)
+    {
+        m_next = position / 8;
+        m_buffer = 0;
+        m_count = 0;
+
+        uint32_t bits = position % 8;
+        if (bits != 0)
+        {
+            refill();
+            drop(bits);
+        }
+    }
+
+private:
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+    std::error_code& m_error;
+
+    /// The index of the next byte to load into the buffer
+    uint64_t m_next = 0;
+
+    /// The number of bytes removed by the filter before m_next
+    uint64_t m_removed = 0;
+
+    /// The bits of the stream from the bit position
+    uint64_t m_buffer = 0;
+
+    /// The number of bits in the buffer
+    uint32_t m_count = 0;
+
+    /// The filter state
+    Filter m_filter;
+};
+}
@@ -0,0 +1,133 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// The byte order, byte swapping, unaligned load and bit counting helpers
+// shared by the decoders.
+
+// Whether functions for newer x86 instruction sets can be compiled with
+// target attributes and selected at runtime
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BNB_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace bnb
+{
+namespace detail
+{
+/// Whether the host stores integers in little endian byte order
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static const bool host_is_little_endian = false;
+#else
+static const bool host_is_little_endian = true;
+#endif
+
+/// Byte swaps a single value of a given size
+template<uint8_t Bytes>
+struct byte_swap;
+
+template<>
+struct byte_swap<2>
+{
+    static uint16_t swap(uint16_t value)
+    {
+        return (uint16_t)((value >> 8) | (value << 8));
+    }
+};
+
+template<>
+struct byte_swap<4>
+{
+    static uint32_t swap(uint32_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_bswap32(value);
+#else
+        return ((value & 0x000000FFU) << 24) | ((value & 0x0000FF00U) << 8) |
+               ((value & 0x00FF0000U) >> 8) | ((value & 0xFF000000U) >> 24);
+#endif
+    }
+};
+
+template<>
+struct byte_swap<8>
+{
+    static uint64_t swap(uint64_t value)
+    {
+#if defined(__GNUC__)
+        return __builtin_bswap64(value);
+#else
+        return ((uint64_t)byte_swap<4>::swap((uint32_t)value) << 32) |
+               byte_swap<4>::swap((uint32_t)(value >> 32));
+#endif
+    }
+};
+
+/// Loads 8 bytes in little endian byte order from unaligned memory
+inline uint64_t load_little_endian_u64(const uint8_t* data)
+{
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return host_is_little_endian ? word : byte_swap<8>::swap(word);
+}
+
+/// Loads 8 bytes in big endian byte order from unaligned memory
+inline uint64_t load_big_endian_u64(const uint8_t* data)
+{
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return host_is_little_endian ? byte_swap<8>::swap(word) : word;
+}
+
+/// @return The number of trailing zero bits in a non-zero value
+inline uint32_t count_trailing_zeros(uint64_t value)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (uint32_t)index;
+#else
+    uint32_t count = 0;
+    while ((value & 1) == 0)
+    {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// @return The number of leading zero bits in a non-zero value
+inline uint32_t count_leading_zeros(uint64_t value)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (uint32_t)index;
+#else
+    uint32_t count = 0;
+    while ((value & (uint64_t(1) << 63)) == 0)
+    {
+        value <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+}
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <bitter/writer.hpp>
+#include <bitter/msb0.hpp>
+#include <bitter/lsb0.hpp>
+
+namespace bnb
+{
+template<class Endianness, class Type, class BitNumbering, uint32_t... Sizes>
+class bit_writer
+{
+private:
+
+    /// The internal bitter writer type
+    using writer_type = bitter::writer<Type, BitNumbering, Sizes...>;
+
+public:
+
+    /// The data type used as storage for this bit writer.
+    using value_type = typename Type::type;
+
+public:
+
+    /// Constructs a bit writer
+    /// @param data The destination of the packed value. The memory must be
+    ///             at least Type::size bytes and already bounds checked.
+    ///             May be a nullptr if the error code has been set.
+    /// @param error The error code to check before writing
+    bit_writer(uint8_t* data, std::error_code& error) :
+        m_data(data),
+        m_error(error)
+    { }
+
+    /// Sets the value of the field at a given index and updates the
+    /// destination buffer.
+    /// @param value The value of the field. Nothing will be written if the
+    ///              error code has been set.
+    /// @return A reference to this object so that the next field can be set.
+    template<uint32_t Index, class ValueType>
+    bit_writer& set(ValueType value)
+    {
+        if (m_error)
+            return *this;
+
+        m_writer.template field<Index>(value);
+        Endianness::template put_bytes<Type::size>(m_writer.data(), m_data);
+        return *this;
+    }
+
+private:
+
+    writer_type m_writer;
+    uint8_t* m_data;
+    std::error_code& m_error;
+};
+}
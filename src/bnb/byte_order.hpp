@@ -0,0 +1,152 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <utility>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include "error.hpp"
+#include "status.hpp"
+#include "stream_reader.hpp"
+
+namespace bnb
+{
+/// The byte order of a format which is only known at runtime, e.g. from a
+/// magic number or a byte order mark
+enum class byte_order
+{
+    big_endian,
+    little_endian
+};
+
+/// Parses a message whose byte order is only known at runtime.
+///
+/// The byte order is checked once, and the parse function is called with a
+/// stream_reader of that byte order. The parse function is typically a
+/// generic lambda, so it is compiled once per byte order and its field reads
+/// don't branch on the byte order:
+///
+///     auto length = bnb::parse_with_byte_order(order, data, size, error,
+///         [](auto& reader)
+///         {
+///             uint32_t length = 0;
+///             reader.template read_bytes<4>(length);
+///             return length;
+///         });
+///
+/// @param order The byte order of the message
+/// @param data The pointer to the data
+/// @param size The size of the data
+/// @param error The error state of the reader, std::error_code or status
+/// @param parse Called as parse(reader) with a stream_reader over the data.
+///        It must return the same type for both byte orders.
+/// @return The value returned by parse
+template<class Error, class Parse>
+auto parse_with_byte_order(byte_order order, const uint8_t* data,
+                           uint64_t size, Error& error, Parse&& parse)
+{
+    using big_endian_reader = stream_reader<
+        endian::big_endian, no_diagnostics, no_stats, Error>;
+    using little_endian_reader = stream_reader<
+        endian::little_endian, no_diagnostics, no_stats, Error>;
+
+    if (order == byte_order::big_endian)
+    {
+        big_endian_reader reader(data, size, error);
+        return parse(reader);
+    }
+
+    little_endian_reader reader(data, size, error);
+    return parse(reader);
+}
+
+/// Detects the byte order of a message from a magic number at its start,
+/// e.g. 0xA1B2C3D4 for pcap.
+///
+/// The magic number is big endian if the bytes equal it in big endian, and
+/// little endian if they equal it in little endian. Otherwise the error is
+/// set to bnb::error::unexpected_value, or bnb::error::truncated if the
+/// message is too short.
+///
+/// @param magic The magic number
+/// @param data The pointer to the data
+/// @param size The size of the data
+/// @param error The error state to set if the byte order is not found
+/// @param order The detected byte order
+/// @return True if the byte order was detected
+template<uint8_t Bytes, class Error>
+bool detect_byte_order(uint64_t magic, const uint8_t* data, uint64_t size,
+                       Error& error, byte_order& order)
+{
+    static_assert(Bytes > 0 && Bytes <= 8, "Bytes must be from 1 to 8");
+
+    if (error)
+        return false;
+
+    if (Bytes > size)
+    {
+        detail::set_error(error, bnb::error::truncated);
+        return false;
+    }
+
+    uint64_t big = 0;
+    uint64_t little = 0;
+    for (uint32_t i = 0; i < Bytes; ++i)
+    {
+        big = (big << 8) | data[i];
+        little = (little << 8) | data[Bytes - 1 - i];
+    }
+
+    if (big == magic)
+    {
+        order = byte_order::big_endian;
+        return true;
+    }
+    if (little == magic)
+    {
+        order = byte_order::little_endian;
+        return true;
+    }
+
+    detail::set_error(error, bnb::error::unexpected_value);
+    return false;
+}
+
+/// Parses a message which starts with a magic number of Bytes bytes giving
+/// its byte order, see detect_byte_order() and parse_with_byte_order().
+///
+/// The reader passed to parse covers the whole message and is positioned
+/// after the magic number, so positions are offsets in the message.
+///
+/// @param magic The magic number
+/// @param data The pointer to the data
+/// @param size The size of the data
+/// @param error The error state of the reader, std::error_code or status
+/// @param parse Called as parse(reader) if the byte order was detected
+/// @return The value returned by parse, or a value initialized value if the
+///         byte order was not detected
+template<uint8_t Bytes, class Error, class Parse>
+auto parse_with_magic(uint64_t magic, const uint8_t* data, uint64_t size,
+                      Error& error, Parse&& parse)
+{
+    using result_type = decltype(parse(std::declval<stream_reader<
+        endian::big_endian, no_diagnostics, no_stats, Error>&>()));
+
+    byte_order order = byte_order::big_endian;
+    if (!detect_byte_order<Bytes>(magic, data, size, error, order))
+        return result_type();
+
+    return parse_with_byte_order(order, data, size, error,
+                                 [&parse](auto& reader)
+    {
+        reader.seek(Bytes);
+        return parse(reader);
+    });
+}
+}
@@ -0,0 +1,351 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "bit_utility.hpp"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace bnb
+{
+namespace detail
+{
+/// The slicing-by-8 tables of a reflected CRC-32 polynomial, which process
+/// 8 bytes per step when no CRC instructions are available
+struct crc32_tables
+{
+    explicit crc32_tables(uint32_t polynomial)
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (uint32_t bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+            m_table[0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            for (uint32_t k = 1; k < 8; ++k)
+            {
+                uint32_t previous = m_table[k - 1][i];
+                m_table[k][i] = (previous >> 8) ^ m_table[0][previous & 0xFF];
+            }
+        }
+    }
+
+    uint32_t m_table[8][256];
+};
+
+/// @return The tables of a polynomial, built on first use
+template<uint32_t Polynomial>
+inline const crc32_tables& crc32_table()
+{
+    static const crc32_tables tables(Polynomial);
+    return tables;
+}
+
+/// Updates a reflected CRC-32 with the slicing-by-8 tables
+inline uint32_t crc32_update_table(const crc32_tables& tables, uint32_t crc,
+                                   const uint8_t* data, uint64_t size)
+{
+    const auto& t = tables.m_table;
+    for (; size >= 8; data += 8, size -= 8)
+    {
+        uint64_t word = load_little_endian_u64(data) ^ crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^
+              t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF] ^
+              t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+              t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+    }
+
+    for (; size > 0; ++data, --size)
+        crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(BNB_X86_DISPATCH)
+
+/// Updates a CRC-32C with the SSE4.2 crc32 instruction
+__attribute__((target("sse4.2")))
+inline uint32_t crc32c_update_sse42(uint32_t crc, const uint8_t* data,
+                                    uint64_t size)
+{
+    uint64_t crc64 = crc;
+    for (; size >= 8; data += 8, size -= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+
+    crc = (uint32_t)crc64;
+    for (; size > 0; ++data, --size)
+        crc = _mm_crc32_u8(crc, *data);
+    return crc;
+}
+
+/// Updates a CRC-32 by folding 64 bytes per step with carry-less
+/// multiplication, as described in "Fast CRC Computation for Generic
+/// Polynomials Using PCLMULQDQ Instruction" by Intel.
+///
+/// @param size The number of bytes, at least 64 and a multiple of 16
+__attribute__((target("pclmul,sse4.1")))
+inline uint32_t crc32_update_pclmul(uint32_t crc, const uint8_t* data,
+                                    uint64_t size)
+{
+    // The constants of the CRC-32 polynomial in the bit-reflected domain
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(data + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(data + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(data + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+
+    __m128i k = _mm_load_si128((const __m128i*)k1k2);
+    data += 64;
+    size -= 64;
+
+    // Fold four blocks of 16 bytes in parallel
+    for (; size >= 64; data += 64, size -= 64)
+    {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128((const __m128i*)(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128((const __m128i*)(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128((const __m128i*)(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128((const __m128i*)(data + 0x30)));
+    }
+
+    // Fold the four blocks into one
+    k = _mm_load_si128((const __m128i*)k3k4);
+    __m128i low = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), low);
+
+    low = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), low);
+
+    low = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), low);
+
+    // Fold the remaining blocks of 16 bytes
+    for (; size >= 16; data += 16, size -= 16)
+    {
+        low = _mm_clmulepi64_si128(x1, k, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, low),
+                           _mm_loadu_si128((const __m128i*)data));
+    }
+
+    // Fold 128 bits to 64 bits
+    const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    k = _mm_loadl_epi64((const __m128i*)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128((const __m128i*)poly);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+#endif
+}
+
+/// The CRC-32 of Ethernet, zlib and PNG, i.e. the reflected polynomial
+/// 0x04C11DB7.
+///
+/// The bytes are folded with PCLMULQDQ where available, and otherwise with
+/// the ARMv8 CRC instructions or slicing-by-8 tables.
+///
+/// A checksum policy, see checksum_reader, is any class with the functions
+/// of this class.
+class crc32
+{
+public:
+
+    /// The type of the checksum value
+    using value_type = uint32_t;
+
+    /// Adds bytes to the checksum
+    /// @param data The pointer to the bytes
+    /// @param size The number of bytes
+    void update(const uint8_t* data, uint64_t size)
+    {
+#if defined(BNB_X86_DISPATCH)
+        if (size >= 64 && __builtin_cpu_supports("pclmul") &&
+            __builtin_cpu_supports("sse4.1"))
+        {
+            uint64_t blocks = size & ~uint64_t(15);
+            m_crc = detail::crc32_update_pclmul(m_crc, data, blocks);
+            data += blocks;
+            size -= blocks;
+        }
+#elif defined(__ARM_FEATURE_CRC32)
+        for (; size >= 8; data += 8, size -= 8)
+            m_crc = __crc32d(m_crc, detail::load_little_endian_u64(data));
+        for (; size > 0; ++data, --size)
+            m_crc = __crc32b(m_crc, *data);
+#endif
+        m_crc = detail::crc32_update_table(
+            detail::crc32_table<0xEDB88320>(), m_crc, data, size);
+    }
+
+    /// @return The checksum of the bytes added
+    value_type value() const
+    {
+        return ~m_crc;
+    }
+
+    /// Restarts the checksum
+    void clear()
+    {
+        m_crc = 0xFFFFFFFF;
+    }
+
+private:
+
+    uint32_t m_crc = 0xFFFFFFFF;
+};
+
+/// The CRC-32C (Castagnoli) of iSCSI, SCTP and ext4, i.e. the reflected
+/// polynomial 0x1EDC6F41.
+///
+/// The bytes are processed with the SSE4.2 or ARMv8 CRC instructions where
+/// available, and otherwise with slicing-by-8 tables.
+class crc32c
+{
+public:
+
+    using value_type = uint32_t;
+
+    void update(const uint8_t* data, uint64_t size)
+    {
+#if defined(BNB_X86_DISPATCH)
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            m_crc = detail::crc32c_update_sse42(m_crc, data, size);
+            return;
+        }
+#elif defined(__ARM_FEATURE_CRC32)
+        for (; size >= 8; data += 8, size -= 8)
+            m_crc = __crc32cd(m_crc, detail::load_little_endian_u64(data));
+        for (; size > 0; ++data, --size)
+            m_crc = __crc32cb(m_crc, *data);
+#endif
+        m_crc = detail::crc32_update_table(
+            detail::crc32_table<0x82F63B78>(), m_crc, data, size);
+    }
+
+    value_type value() const
+    {
+        return ~m_crc;
+    }
+
+    void clear()
+    {
+        m_crc = 0xFFFFFFFF;
+    }
+
+private:
+
+    uint32_t m_crc = 0xFFFFFFFF;
+};
+
+/// The 16-bit ones' complement checksum of IPv4, TCP and UDP, see RFC 1071.
+///
+/// The sum is computed over 32-bit words, which gives the same result once
+/// folded to 16 bits, and the bytes may be added in blocks of any size.
+class internet_checksum
+{
+public:
+
+    using value_type = uint16_t;
+
+    void update(const uint8_t* data, uint64_t size)
+    {
+        if (size == 0)
+            return;
+
+        // A byte following an odd number of bytes is the low byte of a word
+        if (m_odd)
+        {
+            m_sum += *data;
+            ++data;
+            --size;
+            m_odd = false;
+        }
+
+        for (; size >= 8; data += 8, size -= 8)
+        {
+            uint64_t word = detail::load_big_endian_u64(data);
+            m_sum += (word >> 32) + (word & 0xFFFFFFFF);
+        }
+
+        for (; size >= 2; data += 2, size -= 2)
+            m_sum += ((uint32_t)data[0] << 8) | data[1];
+
+        if (size == 1)
+        {
+            m_sum += (uint32_t)data[0] << 8;
+            m_odd = true;
+        }
+
+        // Fold, so the sum can't overflow however many blocks are added
+        m_sum = (m_sum & 0xFFFFFFFF) + (m_sum >> 32);
+    }
+
+    value_type value() const
+    {
+        uint64_t sum = m_sum;
+        while (sum > 0xFFFF)
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        return (value_type)~sum;
+    }
+
+    void clear()
+    {
+        m_sum = 0;
+        m_odd = false;
+    }
+
+private:
+
+    uint64_t m_sum = 0;
+    bool m_odd = false;
+};
+}
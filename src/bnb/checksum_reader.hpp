@@ -0,0 +1,134 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+
+#include "checksum.hpp"
+#include "error.hpp"
+#include "stream_reader.hpp"
+
+namespace bnb
+{
+/// A stream reader which computes a checksum over the bytes it consumes, so
+/// a frame can be verified while it is parsed instead of in a second pass.
+///
+/// The consumed bytes are added to the Checksum, e.g. crc32, crc32c or
+/// internet_checksum, in a single block when the checksum is needed, while
+/// they are still in the cache. Bytes which are skipped or read as views
+/// are consumed too, while peeked bytes are not.
+///
+/// Seeking back over bytes which have been added to the checksum, i.e. to
+/// before the position where checksum() was last called or the checksum
+/// was restarted, sets the error code to bnb::error::invalid_seek, as the
+/// checksum would otherwise be wrong. Seeking back over bytes consumed since
+/// then is allowed, they are only added once. Note, seek() is not virtual,
+/// so a seek through a reference to the stream_reader is only detected
+/// when the checksum is next needed, and only if the read position is still
+/// before the bytes added to the checksum.
+///
+/// The Diagnostics, Stats and Error policies are those of stream_reader.
+template<class Checksum, class Endianness,
+         class Diagnostics = no_diagnostics, class Stats = no_stats,
+         class Error = std::error_code>
+class checksum_reader :
+    public stream_reader<Endianness, Diagnostics, Stats, Error>
+{
+private:
+
+    /// The type of the underlying reader
+    using reader_type = stream_reader<Endianness, Diagnostics, Stats, Error>;
+
+public:
+
+    /// The type of the checksum value
+    using checksum_type = typename Checksum::value_type;
+
+public:
+
+    /// Constructs a checksum reader with the arguments of the stream_reader
+    /// constructors, i.e. the data, its size, the error state and
+    /// optionally the diagnostics sink and stats.
+    using reader_type::reader_type;
+
+    /// @return The checksum of the bytes consumed since the reader was
+    ///         constructed or the checksum was restarted. If the reader has
+    ///         seeked back over these bytes the error code is set.
+    checksum_type checksum()
+    {
+        update();
+        return m_checksum.value();
+    }
+
+    /// Reads a checksum field of Bytes bytes, checks that it matches the
+    /// checksum of the bytes consumed before it and restarts the checksum
+    /// after it, ready for the next frame.
+    ///
+    /// @return The validator of the checksum field, where the mismatch has
+    ///         set bnb::error::unexpected_value
+    template<uint8_t Bytes>
+    auto expect_checksum()
+    {
+        checksum_type computed = checksum();
+        checksum_type stored = 0;
+        auto validator = this->template read_bytes<Bytes>(stored);
+        validator.expect_eq(computed);
+        restart();
+        return validator;
+    }
+
+    /// Changes the read position, see stream_reader::seek().
+    ///
+    /// @param new_position The new position. Positions before the bytes
+    ///        added to the checksum set bnb::error::invalid_seek.
+    void seek(uint64_t new_position)
+    {
+        if (!this->m_error && new_position < m_mark)
+        {
+            detail::set_error(this->m_error, bnb::error::invalid_seek);
+            return;
+        }
+
+        reader_type::seek(new_position);
+    }
+
+    /// Restarts the checksum at the read position
+    void restart()
+    {
+        m_checksum.clear();
+        m_mark = this->m_stream.position();
+    }
+
+private:
+
+    /// Adds the bytes consumed since the last update to the checksum
+    void update()
+    {
+        uint64_t position = this->m_stream.position();
+        if (position < m_mark)
+        {
+            detail::set_error(this->m_error, bnb::error::invalid_seek);
+            return;
+        }
+
+        if (position > m_mark)
+        {
+            m_checksum.update(this->m_stream.data() + m_mark,
+                              position - m_mark);
+        }
+        m_mark = position;
+    }
+
+private:
+
+    /// The checksum of the bytes before m_mark
+    Checksum m_checksum;
+
+    /// The position up to which the bytes have been added to the checksum
+    uint64_t m_mark = 0;
+};
+}
@@ -0,0 +1,36 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace bnb
+{
+namespace detail
+{
+/// The type of the compile-time constants checked against values of a
+/// given type, e.g. by validator_wrapper::expect_eq<>().
+///
+/// Only integral and enumeration types can be template parameters, so other
+/// types like double map to std::nullptr_t, and the checks taking constants
+/// are disabled for them with constant_check.
+template<class ValueType>
+struct constant_type
+{
+    using type = typename std::conditional<
+        std::is_integral<ValueType>::value || std::is_enum<ValueType>::value,
+        ValueType, std::nullptr_t>::type;
+};
+
+/// Enables a check taking compile-time constants if the value type can be a
+/// template parameter, see constant_type
+template<class ValueType>
+using constant_check = typename std::enable_if<
+    !std::is_same<typename constant_type<ValueType>::type,
+                  std::nullptr_t>::value, int>::type;
+}
+}
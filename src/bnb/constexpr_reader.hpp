@@ -0,0 +1,506 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <utility>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+#include <bitter/msb0.hpp>
+#include <bitter/lsb0.hpp>
+
+#include "constant_type.hpp"
+#include "error.hpp"
+
+namespace bnb
+{
+namespace detail
+{
+/// Decodes integers in constant expressions, as the endian functions are not
+/// constexpr.
+template<class Endianness>
+struct constexpr_bytes;
+
+template<>
+struct constexpr_bytes<endian::big_endian>
+{
+    /// @return The integer stored in the bytes
+    static constexpr uint64_t get(const uint8_t* data, uint32_t bytes)
+    {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < bytes; ++i)
+            value = (value << 8) | data[i];
+        return value;
+    }
+};
+
+template<>
+struct constexpr_bytes<endian::little_endian>
+{
+    static constexpr uint64_t get(const uint8_t* data, uint32_t bytes)
+    {
+        uint64_t value = 0;
+        for (uint32_t i = bytes; i > 0; --i)
+            value = (value << 8) | data[i - 1];
+        return value;
+    }
+};
+
+/// The shift of a bit field within a value, matching bitter::reader
+template<class BitNumbering>
+struct constexpr_bit_shift;
+
+template<>
+struct constexpr_bit_shift<bitter::msb0>
+{
+    /// @return The number of bits below the field
+    static constexpr uint32_t get(uint32_t total, uint32_t offset,
+                                  uint32_t size)
+    {
+        return total - offset - size;
+    }
+};
+
+template<>
+struct constexpr_bit_shift<bitter::lsb0>
+{
+    static constexpr uint32_t get(uint32_t, uint32_t offset, uint32_t)
+    {
+        return offset;
+    }
+};
+
+/// The default Super of a constexpr_validator, which has nothing to forward
+struct constexpr_empty
+{ };
+
+/// Forwards the get calls of a constexpr_validator to the bit reader it was
+/// created by, if it is an lvalue, see bit_reader_reference.
+template<class BitReader>
+class constexpr_bit_reader_reference
+{
+public:
+
+    /// @param reader The bit reader to forward to
+    constexpr constexpr_bit_reader_reference(BitReader& reader) :
+        m_reader(reader)
+    { }
+
+    /// Forwards to BitReader::get()
+    template<uint32_t Index, class ValueType>
+    constexpr auto get(ValueType& value) const
+    {
+        return m_reader.template get<Index, ValueType>(value);
+    }
+
+    /// Forwards to BitReader::get()
+    template<uint32_t Index>
+    constexpr auto get() const
+    {
+        return m_reader.template get<Index>();
+    }
+
+private:
+
+    BitReader& m_reader;
+};
+}
+
+/// Validates a value read by a constexpr_reader, see validator_wrapper.
+///
+/// The error state is a bnb::error held by value in the reader, where
+/// bnb::error() means no error, so the checks can run in constant
+/// expressions.
+template<class ValueType, class Super = detail::constexpr_empty>
+class constexpr_validator : public Super
+{
+public:
+
+    /// Constructs a validator
+    /// @param super The object to forward calls to
+    /// @param value The value to check
+    /// @param error The error state to set if the validation failed
+    constexpr constexpr_validator(const Super& super, ValueType value,
+                                  bnb::error& error) :
+        Super(super),
+        m_value(value),
+        m_error(error)
+    { }
+
+    /// Checks if the value is equal to the expected value.
+    constexpr constexpr_validator& expect_eq(ValueType expected_value)
+    {
+        return check(m_value == expected_value, bnb::error::unexpected_value);
+    }
+
+    /// Checks if the value is not equal to the expected value.
+    constexpr constexpr_validator& expect_ne(ValueType expected_value)
+    {
+        return check(m_value != expected_value, bnb::error::unexpected_value);
+    }
+
+    /// Checks if the value is less than the expected value.
+    constexpr constexpr_validator& expect_lt(ValueType expected_value)
+    {
+        return check(m_value < expected_value,
+                     bnb::error::value_out_of_range);
+    }
+
+    /// Checks if the value is less than or equal to the expected value.
+    constexpr constexpr_validator& expect_le(ValueType expected_value)
+    {
+        return check(!(expected_value < m_value),
+                     bnb::error::value_out_of_range);
+    }
+
+    /// Checks if the value is greater than the expected value.
+    constexpr constexpr_validator& expect_gt(ValueType expected_value)
+    {
+        return check(expected_value < m_value,
+                     bnb::error::value_out_of_range);
+    }
+
+    /// Checks if the value is greater than or equal to the expected value.
+    constexpr constexpr_validator& expect_ge(ValueType expected_value)
+    {
+        return check(!(m_value < expected_value),
+                     bnb::error::value_out_of_range);
+    }
+
+    /// Checks if the value is within the range [Min, Max]. Only available
+    /// for integral and enumeration values.
+    template<typename detail::constant_type<ValueType>::type Min,
+             typename detail::constant_type<ValueType>::type Max,
+             class T = ValueType, detail::constant_check<T> = 0>
+    constexpr constexpr_validator& expect_in_range()
+    {
+        static_assert(Min <= Max, "Min must not be greater than Max");
+        return check(!(m_value < Min) && !(Max < m_value),
+                     bnb::error::value_out_of_range);
+    }
+
+    /// Checks if the predicate returns true for the value. In a constant
+    /// expression the predicate must be constexpr, e.g. a lambda from C++17.
+    template<class Predicate>
+    constexpr constexpr_validator& expect(Predicate&& predicate)
+    {
+        return check(predicate(m_value), bnb::error::predicate_failed);
+    }
+
+private:
+
+    /// Sets the error state unless the check passed or it was already set
+    constexpr constexpr_validator& check(bool passed, bnb::error error)
+    {
+        if (m_error == bnb::error() && !passed)
+            m_error = error;
+        return *this;
+    }
+
+    ValueType m_value;
+    bnb::error& m_error;
+};
+
+/// Reads bit fields from a value in constant expressions, see bit_reader.
+template<class Type, class BitNumbering, uint32_t... Sizes>
+class constexpr_bit_reader
+{
+private:
+
+    /// The reference to this bit reader which is wrapped by the validators
+    using reference_type =
+        detail::constexpr_bit_reader_reference<constexpr_bit_reader>;
+
+public:
+
+    /// The data type used as storage for this bit reader.
+    using value_type = typename Type::type;
+
+public:
+
+    /// Constructs a bit reader
+    /// @param value The value to serve as the data for this bit reader
+    /// @param error The error state to set upon error
+    constexpr constexpr_bit_reader(value_type value, bnb::error& error) :
+        m_value(value),
+        m_error(error)
+    { }
+
+    /// Reads the field at a given index
+    /// @param value The destination for the read value. Nothing will be read
+    ///              if the error state has been set.
+    /// @return A reference to this object wrapped in a validator object.
+    template<uint32_t Index, class ValueType>
+    constexpr constexpr_validator<ValueType, reference_type> get(
+        ValueType& value) &
+    {
+        read<Index>(value);
+        return { reference_type(*this), value, m_error };
+    }
+
+    /// Reads the field at a given index of a temporary bit reader
+    /// @param value The destination for the read value. Nothing will be read
+    ///              if the error state has been set.
+    /// @return A copy of this object wrapped in a validator object.
+    template<uint32_t Index, class ValueType>
+    constexpr constexpr_validator<ValueType, constexpr_bit_reader> get(
+        ValueType& value) &&
+    {
+        read<Index>(value);
+        return { *this, value, m_error };
+    }
+
+    /// Reads the field at a given index without storing the value
+    template<uint32_t Index>
+    constexpr auto get() &
+    {
+        value_type value = 0;
+        return get<Index, value_type>(value);
+    }
+
+    /// Reads the field at a given index of a temporary bit reader without
+    /// storing the value
+    template<uint32_t Index>
+    constexpr auto get() &&
+    {
+        value_type value = 0;
+        return std::move(*this).template get<Index, value_type>(value);
+    }
+
+private:
+
+    /// Reads the field at a given index unless the error state has been set
+    template<uint32_t Index, class ValueType>
+    constexpr void read(ValueType& value) const
+    {
+        static_assert(Index < sizeof...(Sizes), "Index out of range");
+
+        if (m_error == bnb::error())
+            value = (ValueType)field(Index);
+    }
+
+    /// @return The field at the index
+    constexpr uint64_t field(uint32_t index) const
+    {
+        const uint32_t sizes[] = { Sizes... };
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < index; ++i)
+            offset += sizes[i];
+
+        uint32_t size = sizes[index];
+        uint32_t shift = detail::constexpr_bit_shift<BitNumbering>::get(
+            Type::size * 8, offset, size);
+        uint64_t mask = size == 64 ? ~uint64_t(0) : (uint64_t(1) << size) - 1;
+        return ((uint64_t)m_value >> shift) & mask;
+    }
+
+private:
+
+    value_type m_value;
+    bnb::error& m_error;
+};
+
+/// Reads values from a buffer in constant expressions, e.g. to decode a
+/// fixed table at compile time or to check a parse with static_assert.
+///
+/// Unlike stream_reader the error state is held by value, see error(), and
+/// the integers are decoded with plain loops, which the compiler also
+/// evaluates at runtime when used with a runtime buffer.
+///
+///     constexpr uint8_t table[] = {0x01, 0x02, 0x03};
+///
+///     constexpr uint32_t parse()
+///     {
+///         bnb::constexpr_reader<endian::big_endian> reader(table);
+///         uint32_t value = 0;
+///         reader.read_bytes<2>(value).expect_lt(0x1000);
+///         return reader.error() == bnb::error() ? value : 0;
+///     }
+///     static_assert(parse() == 0x0102, "");
+template<class Endianness>
+class constexpr_reader
+{
+public:
+
+    /// Constructs a reader over a buffer.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the data in bytes
+    constexpr constexpr_reader(const uint8_t* data, uint64_t size) :
+        m_data(data),
+        m_size(size)
+    { }
+
+    /// Constructs a reader over an array.
+    ///
+    /// @param data The array to read
+    template<uint64_t Size>
+    constexpr constexpr_reader(const uint8_t (&data)[Size]) :
+        constexpr_reader(data, Size)
+    { }
+
+    /// Reads from the stream and moves the read position.
+    ///
+    /// @param value reference to the value to be read.
+    template<uint8_t Bytes, class ValueType>
+    constexpr constexpr_validator<ValueType> read_bytes(ValueType& value)
+    {
+        static_assert(Bytes > 0 && Bytes <= 8, "Bytes must be from 1 to 8");
+
+        if (available(0, Bytes, bnb::error::truncated))
+        {
+            value = (ValueType)detail::constexpr_bytes<Endianness>::get(
+                m_data + m_position, Bytes);
+            m_position += Bytes;
+        }
+        return { detail::constexpr_empty(), value, m_error };
+    }
+
+    /// Reads from the stream and moves the read position.
+    template<uint8_t Bytes>
+    constexpr constexpr_validator<uint64_t> read_bytes()
+    {
+        uint64_t value = 0;
+        return read_bytes<Bytes, uint64_t>(value);
+    }
+
+    /// Peeks in the stream without moving the read position.
+    ///
+    /// @param value reference to the value to be read.
+    /// @param offset number of bytes to offset the peeking with
+    template<uint8_t Bytes, class ValueType>
+    constexpr constexpr_validator<ValueType> peek_bytes(
+        ValueType& value, uint64_t offset=0)
+    {
+        static_assert(Bytes > 0 && Bytes <= 8, "Bytes must be from 1 to 8");
+
+        if (available(offset, Bytes, bnb::error::truncated))
+        {
+            value = (ValueType)detail::constexpr_bytes<Endianness>::get(
+                m_data + m_position + offset, Bytes);
+        }
+        return { detail::constexpr_empty(), value, m_error };
+    }
+
+    /// Reads raw bytes from the stream and moves the read position.
+    ///
+    /// @param data The data pointer to fill into
+    /// @param size The number of bytes to fill.
+    constexpr void read(uint8_t* data, uint64_t size)
+    {
+        if (!available(0, size, bnb::error::truncated))
+            return;
+
+        for (uint64_t i = 0; i < size; ++i)
+            data[i] = m_data[m_position + i];
+        m_position += size;
+    }
+
+    /// Returns a bit reader covering a given number of bytes and moves the
+    /// read position.
+    /// @return A bit reader covering the number of bytes in the Type template.
+    template<class Type, class BitNumbering, uint32_t... Sizes>
+    constexpr constexpr_bit_reader<Type, BitNumbering, Sizes...> read_bits()
+    {
+        using value_type = typename Type::type;
+        value_type value = 0;
+        read_bytes<Type::size>(value);
+        return { value, m_error };
+    }
+
+    /// Changes the read position, which is relative to the beginning of the
+    /// buffer.
+    ///
+    /// @param new_position the new position
+    constexpr void seek(uint64_t new_position)
+    {
+        if (m_error != bnb::error())
+            return;
+
+        if (new_position > m_size)
+        {
+            m_error = bnb::error::invalid_seek;
+            return;
+        }
+        m_position = new_position;
+    }
+
+    /// Skips over a given number of bytes in the stream
+    ///
+    /// @param bytes_to_skip the bytes to skip
+    constexpr void skip(uint64_t bytes_to_skip)
+    {
+        if (available(0, bytes_to_skip, bnb::error::invalid_seek))
+            m_position += bytes_to_skip;
+    }
+
+    /// @return The current read position
+    constexpr uint64_t position() const
+    {
+        return m_position;
+    }
+
+    /// @return The remaining number of bytes in the stream
+    constexpr uint64_t remaining_size() const
+    {
+        return m_size - m_position;
+    }
+
+    /// @return The pointer to the stream's data
+    constexpr const uint8_t* data() const
+    {
+        return m_data;
+    }
+
+    /// @return The size of the buffer in bytes
+    constexpr uint64_t size() const
+    {
+        return m_size;
+    }
+
+    /// @return The error state, where bnb::error() means no error
+    constexpr bnb::error error() const
+    {
+        return m_error;
+    }
+
+    /// @return The error state as an error code, for use at runtime
+    std::error_code error_code() const
+    {
+        if (m_error == bnb::error())
+            return std::error_code();
+        return bnb::make_error_code(m_error);
+    }
+
+private:
+
+    /// Checks that bytes are available at an offset from the read position,
+    /// otherwise sets the error state.
+    /// @return True if no error has been set and the bytes are available
+    constexpr bool available(uint64_t offset, uint64_t bytes,
+                             bnb::error error)
+    {
+        if (m_error != bnb::error())
+            return false;
+
+        // Check the offset first, so the subtraction can't wrap around
+        if (offset > remaining_size() || bytes > remaining_size() - offset)
+        {
+            m_error = error;
+            return false;
+        }
+        return true;
+    }
+
+private:
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+    uint64_t m_position = 0;
+    bnb::error m_error = bnb::error();
+};
+}
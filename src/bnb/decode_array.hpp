@@ -0,0 +1,151 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include "bit_utility.hpp"
+
+namespace bnb
+{
+namespace detail
+{
+/// Whether values in the given endianness are stored in host byte order
+template<class Endianness>
+struct is_host_order
+{
+    static const bool value =
+        std::is_same<Endianness, endian::little_endian>::value ==
+        host_is_little_endian;
+};
+
+/// Byte swaps the elements of an array with scalar instructions
+template<uint8_t Bytes, class ValueType>
+inline void swap_array_scalar(
+    const uint8_t* data, ValueType* out, uint64_t count)
+{
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        ValueType value;
+        std::memcpy(&value, data + i * Bytes, Bytes);
+        out[i] = (ValueType)byte_swap<Bytes>::swap(value);
+    }
+}
+
+#if defined(BNB_X86_DISPATCH)
+
+/// The pshufb mask reversing the bytes of each element of a given size
+template<uint8_t Bytes>
+inline __m128i swap_mask()
+{
+    alignas(16) uint8_t mask[16];
+    for (uint32_t i = 0; i < 16; ++i)
+        mask[i] = (uint8_t)((i / Bytes) * Bytes + (Bytes - 1 - i % Bytes));
+    return _mm_load_si128((const __m128i*)mask);
+}
+
+/// Byte swaps the elements of an array using 16 byte SSSE3 shuffles.
+/// @return The number of elements handled.
+template<uint8_t Bytes, class ValueType>
+__attribute__((target("ssse3")))
+inline uint64_t swap_array_ssse3(
+    const uint8_t* data, ValueType* out, uint64_t count)
+{
+    const __m128i mask = swap_mask<Bytes>();
+    const uint64_t per_vector = 16 / Bytes;
+    uint64_t i = 0;
+    for (; i + per_vector <= count; i += per_vector)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i * Bytes));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+/// Byte swaps the elements of an array using 32 byte AVX2 shuffles.
+/// @return The number of elements handled.
+template<uint8_t Bytes, class ValueType>
+__attribute__((target("avx2")))
+inline uint64_t swap_array_avx2(
+    const uint8_t* data, ValueType* out, uint64_t count)
+{
+    const __m128i half_mask = swap_mask<Bytes>();
+    const __m256i mask = _mm256_broadcastsi128_si256(half_mask);
+    const uint64_t per_vector = 32 / Bytes;
+    uint64_t i = 0;
+    for (; i + per_vector <= count; i += per_vector)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i * Bytes));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+#endif
+
+/// Decodes an array of values which are byte swapped compared to the host
+template<uint8_t Bytes, class ValueType>
+inline void swap_array(const uint8_t* data, ValueType* out, uint64_t count)
+{
+    uint64_t done = 0;
+#if defined(BNB_X86_DISPATCH)
+    if (__builtin_cpu_supports("avx2"))
+        done = swap_array_avx2<Bytes>(data, out, count);
+    else if (__builtin_cpu_supports("ssse3"))
+        done = swap_array_ssse3<Bytes>(data, out, count);
+#endif
+    swap_array_scalar<Bytes>(data + done * Bytes, out + done, count - done);
+}
+
+/// Decodes an array where the element size matches the value type
+template<class Endianness, uint8_t Bytes, class ValueType>
+inline void decode_array(const uint8_t* data, ValueType* out, uint64_t count,
+                         std::true_type)
+{
+    if (count == 0)
+        return;
+
+    if (is_host_order<Endianness>::value)
+        std::memcpy(out, data, count * Bytes);
+    else
+        swap_array<Bytes>(data, out, count);
+}
+
+/// Decodes an array of elements of an arbitrary size one at a time
+template<class Endianness, uint8_t Bytes, class ValueType>
+inline void decode_array(const uint8_t* data, ValueType* out, uint64_t count,
+                         std::false_type)
+{
+    for (uint64_t i = 0; i < count; ++i)
+        Endianness::template get_bytes<Bytes, ValueType>(
+            out[i], data + i * Bytes);
+}
+}
+
+/// Decodes an array of integers of a given size and endianness.
+///
+/// Arrays of 2, 4 and 8 byte elements decoded into equally sized integers
+/// are copied directly when the endianness matches the host and byte
+/// swapped using SSSE3 or AVX2, when supported by the CPU, otherwise.
+///
+/// @param data Pointer to count * Bytes bytes of encoded data
+/// @param out Pointer to room for count values
+/// @param count The number of values to decode
+template<class Endianness, uint8_t Bytes, class ValueType>
+inline void decode_array(const uint8_t* data, ValueType* out, uint64_t count)
+{
+    using fast_path = std::integral_constant<bool,
+        (Bytes == 2 || Bytes == 4 || Bytes == 8) &&
+        sizeof(ValueType) == Bytes &&
+        std::is_integral<ValueType>::value>;
+
+    detail::decode_array<Endianness, Bytes>(data, out, count, fast_path());
+}
+}
@@ -0,0 +1,208 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+
+namespace bnb
+{
+/// The check which failed
+enum class diagnostic_kind
+{
+    /// A read, peek, seek or skip failed
+    read,
+    expect_eq,
+    expect_ne,
+    expect_lt,
+    expect_le,
+    expect_gt,
+    expect_ge,
+    expect_in_range,
+
+    /// An expect check with a custom predicate
+    expect
+};
+
+/// The description of an error reported to a diagnostics sink
+struct diagnostic
+{
+    /// The error code which was set
+    std::error_code error;
+
+    /// The check which failed
+    diagnostic_kind kind;
+
+    /// The byte position in the stream of the value or access that failed
+    uint64_t position;
+
+    /// The bit offset within the value of a failing bit field, i.e. the sum
+    /// of the sizes of the preceding fields
+    uint32_t bit_offset;
+
+    /// The name of the failing field, see stream_reader::field(), or
+    /// nullptr if the field was not named
+    const char* field;
+
+    /// The actual value. For failed reads the number of bytes available.
+    uint64_t actual;
+
+    /// The expected value, or the lower bound for expect_in_range. For
+    /// failed reads the number of bytes needed. Zero for predicates.
+    uint64_t expected;
+
+    /// The upper bound for expect_in_range, otherwise equal to expected
+    uint64_t expected_max;
+};
+
+/// The default diagnostics policy, which doesn't record anything. All the
+/// diagnostics code compiles away, so this has no cost.
+struct no_diagnostics
+{ };
+
+/// A diagnostics sink which records the first error reported. As the error
+/// codes are sticky this is the cause of the failure.
+///
+/// A custom sink is any class with a report(const diagnostic&) function.
+class diagnostic_recorder
+{
+public:
+
+    /// Records the diagnostic unless one has already been recorded
+    /// @param diagnostic The description of the error
+    void report(const bnb::diagnostic& diagnostic)
+    {
+        if (m_has_diagnostic)
+            return;
+
+        m_diagnostic = diagnostic;
+        m_has_diagnostic = true;
+    }
+
+    /// @return True if a diagnostic has been recorded
+    bool has_diagnostic() const
+    {
+        return m_has_diagnostic;
+    }
+
+    /// @return The recorded diagnostic
+    const bnb::diagnostic& diagnostic() const
+    {
+        return m_diagnostic;
+    }
+
+    /// Clears the recorded diagnostic, e.g. when clearing the error code
+    void clear()
+    {
+        m_has_diagnostic = false;
+    }
+
+private:
+
+    bnb::diagnostic m_diagnostic = bnb::diagnostic();
+    bool m_has_diagnostic = false;
+};
+
+namespace detail
+{
+/// The state needed to report a diagnostic for a value or an access, i.e.
+/// the sink and where in the stream the value came from.
+template<class Diagnostics>
+class diagnostics_context
+{
+public:
+
+    diagnostics_context() = default;
+
+    /// @param sink The sink to report to
+    explicit diagnostics_context(Diagnostics& sink) :
+        m_sink(&sink)
+    { }
+
+    /// @param position The byte position of the value
+    /// @param bit_offset The bit offset of the value
+    void move_to(uint64_t position, uint32_t bit_offset)
+    {
+        m_position = position;
+        m_bit_offset = bit_offset;
+    }
+
+    /// @param field The name of the field, or nullptr
+    void name(const char* field)
+    {
+        m_field = field;
+    }
+
+    /// @return The byte position of the value
+    uint64_t position() const
+    {
+        return m_position;
+    }
+
+    /// @return The bit offset of the value
+    uint32_t bit_offset() const
+    {
+        return m_bit_offset;
+    }
+
+    /// Reports a diagnostic to the sink, if there is one.
+    template<class Actual, class Expected>
+    void report(const std::error_code& error, diagnostic_kind kind,
+                const Actual& actual, const Expected& expected,
+                const Expected& expected_max) const
+    {
+        if (m_sink == nullptr)
+            return;
+
+        m_sink->report(diagnostic{
+            error, kind, m_position, m_bit_offset, m_field,
+            static_cast<uint64_t>(actual),
+            static_cast<uint64_t>(expected),
+            static_cast<uint64_t>(expected_max)});
+    }
+
+private:
+
+    Diagnostics* m_sink = nullptr;
+    uint64_t m_position = 0;
+    uint32_t m_bit_offset = 0;
+    const char* m_field = nullptr;
+};
+
+/// Without diagnostics the context is empty and does nothing
+template<>
+class diagnostics_context<no_diagnostics>
+{
+public:
+
+    diagnostics_context() = default;
+
+    explicit diagnostics_context(no_diagnostics&)
+    { }
+
+    void move_to(uint64_t, uint32_t)
+    { }
+
+    void name(const char*)
+    { }
+
+    uint64_t position() const
+    {
+        return 0;
+    }
+
+    uint32_t bit_offset() const
+    {
+        return 0;
+    }
+
+    template<class Actual, class Expected>
+    void report(const std::error_code&, diagnostic_kind, const Actual&,
+                const Expected&, const Expected&) const
+    { }
+};
+}
+}
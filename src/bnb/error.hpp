@@ -0,0 +1,135 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace bnb
+{
+/// The error codes specific to bnb
+enum class error
+{
+    /// The data ended before the read could be completed, but more data may
+    /// become available, see resumable_reader.
+    need_more_data = 1,
+
+    /// The data ended before the read could be completed
+    truncated,
+
+    /// A seek or skip went past the end of the data
+    invalid_seek,
+
+    /// A variable-length integer was invalid or overlong
+    invalid_varint,
+
+    /// A variable-length integer doesn't fit in the destination type
+    value_too_large,
+
+    /// A value failed an expect_eq or expect_ne check
+    unexpected_value,
+
+    /// A value failed an expect_lt, expect_le, expect_gt, expect_ge or
+    /// expect_in_range check
+    value_out_of_range,
+
+    /// A value failed an expect check with a custom predicate
+    predicate_failed,
+
+    /// A field width or number of symbols given at runtime was outside its
+    /// valid range
+    invalid_size
+};
+
+namespace detail
+{
+/// The error category of the bnb error codes
+class error_category : public std::error_category
+{
+public:
+
+    /// @return The name of the category
+    const char* name() const noexcept override
+    {
+        return "bnb";
+    }
+
+    /// @return The message of an error code
+    std::string message(int value) const override
+    {
+        switch (static_cast<bnb::error>(value))
+        {
+        case bnb::error::need_more_data:
+            return "need more data";
+        case bnb::error::truncated:
+            return "data truncated";
+        case bnb::error::invalid_seek:
+            return "invalid seek";
+        case bnb::error::invalid_varint:
+            return "invalid variable-length integer";
+        case bnb::error::value_too_large:
+            return "value too large";
+        case bnb::error::unexpected_value:
+            return "unexpected value";
+        case bnb::error::value_out_of_range:
+            return "value out of range";
+        case bnb::error::predicate_failed:
+            return "predicate failed";
+        case bnb::error::invalid_size:
+            return "invalid size";
+        }
+        return "unknown error";
+    }
+
+    /// Maps the error codes to the generic error conditions, which were used
+    /// for all errors before the bnb error codes were introduced.
+    /// @return The generic error condition matching the error code
+    std::error_condition default_error_condition(
+        int value) const noexcept override
+    {
+        switch (static_cast<bnb::error>(value))
+        {
+        case bnb::error::need_more_data:
+        case bnb::error::truncated:
+        case bnb::error::unexpected_value:
+        case bnb::error::value_out_of_range:
+        case bnb::error::predicate_failed:
+            return std::errc::result_out_of_range;
+        case bnb::error::invalid_seek:
+            return std::errc::invalid_seek;
+        case bnb::error::invalid_varint:
+            return std::errc::illegal_byte_sequence;
+        case bnb::error::value_too_large:
+            return std::errc::value_too_large;
+        case bnb::error::invalid_size:
+            return std::errc::invalid_argument;
+        }
+        return std::error_condition(value, *this);
+    }
+};
+}
+
+/// @return The error category of the bnb error codes
+inline const std::error_category& error_category()
+{
+    static detail::error_category category;
+    return category;
+}
+
+/// @return An error code of the bnb error category
+inline std::error_code make_error_code(error value)
+{
+    return std::error_code(static_cast<int>(value), error_category());
+}
+}
+
+namespace std
+{
+template<>
+struct is_error_code_enum<bnb::error> : public true_type
+{ };
+}
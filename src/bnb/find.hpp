@@ -0,0 +1,73 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace bnb
+{
+/// The start code prefix of H.264 and H.265 NAL units and MPEG-2 streams
+const uint8_t start_code[] = {0x00, 0x00, 0x01};
+
+namespace detail
+{
+/// Finds the first occurrence of a byte.
+///
+/// memchr is vectorized by the C libraries, so this runs at close to
+/// memory bandwidth.
+///
+/// @return The pointer to the byte, or nullptr if not found
+inline const uint8_t* find_byte(const uint8_t* data, uint64_t size,
+                                uint8_t byte)
+{
+    if (size == 0)
+        return nullptr;
+
+    return static_cast<const uint8_t*>(std::memchr(data, byte, size));
+}
+
+/// Finds the first occurrence of a pattern.
+///
+/// The search is for the last byte of the pattern with find_byte(), and
+/// only the candidates are compared in full. The last byte is used as
+/// patterns like start codes begin with zero bytes, which are common in
+/// the data, but end with a rarer byte.
+///
+/// An empty pattern is found at the start of the data.
+///
+/// @return The pointer to the start of the pattern, or nullptr if not found
+inline const uint8_t* find_pattern(const uint8_t* data, uint64_t size,
+                                   const uint8_t* pattern,
+                                   uint64_t pattern_size)
+{
+    if (pattern_size == 0)
+        return data;
+
+    if (pattern_size > size)
+        return nullptr;
+
+    const uint64_t prefix_size = pattern_size - 1;
+    const uint8_t last = pattern[prefix_size];
+    const uint8_t* end = data + size;
+    const uint8_t* candidate = data + prefix_size;
+
+    while (candidate < end)
+    {
+        candidate = find_byte(candidate, end - candidate, last);
+        if (candidate == nullptr)
+            return nullptr;
+
+        const uint8_t* start = candidate - prefix_size;
+        if (std::memcmp(start, pattern, prefix_size) == 0)
+            return start;
+
+        ++candidate;
+    }
+    return nullptr;
+}
+}
+}
@@ -0,0 +1,381 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <bitter/reader.hpp>
+#include <bitter/writer.hpp>
+#include <bitter/msb0.hpp>
+#include <bitter/lsb0.hpp>
+
+namespace bnb
+{
+namespace detail
+{
+/// The smallest unsigned integer type which can hold a given number of bytes
+template<uint8_t Bytes>
+struct unsigned_type
+{
+    static_assert(Bytes > 0 && Bytes <= 8, "Bytes must be in the range 1-8");
+    using type = typename std::conditional<Bytes <= 1, uint8_t,
+                 typename std::conditional<Bytes <= 2, uint16_t,
+                 typename std::conditional<Bytes <= 4, uint32_t,
+                 uint64_t>::type>::type>::type;
+};
+
+/// The byte offset of the field at a given index in a list of fields
+template<uint32_t Index, class... Fields>
+struct field_offset;
+
+template<class Field, class... Fields>
+struct field_offset<0, Field, Fields...>
+{
+    static const uint64_t value = 0;
+};
+
+template<uint32_t Index, class Field, class... Fields>
+struct field_offset<Index, Field, Fields...>
+{
+    static const uint64_t value =
+        Field::size + field_offset<Index - 1, Fields...>::value;
+};
+
+/// The total size in bytes of a list of fields
+template<class... Fields>
+struct fields_size;
+
+template<>
+struct fields_size<>
+{
+    static const uint64_t value = 0;
+};
+
+template<class Field, class... Fields>
+struct fields_size<Field, Fields...>
+{
+    static const uint64_t value = Field::size + fields_size<Fields...>::value;
+};
+}
+
+/// Layout descriptor of a byte aligned field of a given number of bytes.
+/// The field is decoded into the smallest unsigned integer which can hold it.
+template<uint8_t Bytes>
+struct field
+{
+    /// The size of the field in bytes
+    static const uint64_t size = Bytes;
+
+    /// The type the field is decoded into
+    using value_type = typename detail::unsigned_type<Bytes>::type;
+
+    /// Decodes the field
+    /// @param data Pointer to the bounds checked data of the field
+    /// @param value The destination of the decoded field
+    template<class Endianness, class ValueType>
+    static void decode(const uint8_t* data, ValueType& value)
+    {
+        Endianness::template get_bytes<Bytes, ValueType>(value, data);
+    }
+
+    /// Encodes the field
+    /// @param data Pointer to the bounds checked destination of the field
+    /// @param value The value of the field
+    template<class Endianness, class ValueType>
+    static void encode(uint8_t* data, const ValueType& value)
+    {
+        Endianness::template put_bytes<Bytes>(
+            static_cast<value_type>(value), data);
+    }
+
+    /// @return True, as the field has no checks, see checked
+    template<class ValueType>
+    static bool check(const ValueType&)
+    {
+        return true;
+    }
+};
+
+template<uint8_t Bytes>
+const uint64_t field<Bytes>::size;
+
+/// Layout descriptor of a number of bytes split into bit fields, see
+/// stream_reader::read_bits(). The bit fields are decoded into an array
+/// with an element per bit field.
+template<class Type, class BitNumbering, uint32_t... Sizes>
+struct bits
+{
+    /// The size of the field in bytes
+    static const uint64_t size = Type::size;
+
+    /// The type the bit fields are decoded into
+    using value_type = std::array<typename Type::type, sizeof...(Sizes)>;
+
+    /// Decodes the bit fields
+    /// @param data Pointer to the bounds checked data of the bit fields
+    /// @param values The destination of the decoded bit fields
+    template<class Endianness, class ValueType>
+    static void decode(const uint8_t* data, ValueType& values)
+    {
+        typename Type::type value = 0;
+        Endianness::template get_bytes<Type::size>(value, data);
+        decode(bitter::reader<Type, BitNumbering, Sizes...>(value), values,
+               std::make_index_sequence<sizeof...(Sizes)>());
+    }
+
+    /// Encodes the bit fields
+    /// @param data Pointer to the bounds checked destination of the bit
+    ///        fields
+    /// @param values The values of the bit fields
+    template<class Endianness, class ValueType>
+    static void encode(uint8_t* data, const ValueType& values)
+    {
+        bitter::writer<Type, BitNumbering, Sizes...> writer;
+        encode(writer, values, std::make_index_sequence<sizeof...(Sizes)>());
+        Endianness::template put_bytes<Type::size>(writer.data(), data);
+    }
+
+    /// @return True, as the bit fields have no checks, see checked
+    template<class ValueType>
+    static bool check(const ValueType&)
+    {
+        return true;
+    }
+
+private:
+
+    template<class Writer, class ValueType, std::size_t... Index>
+    static void encode(Writer& writer, const ValueType& values,
+                       std::index_sequence<Index...>)
+    {
+        (void) std::initializer_list<int>
+        {
+            (writer.template field<Index>(values[Index]), 0)...
+        };
+    }
+
+    template<class Reader, class ValueType, std::size_t... Index>
+    static void decode(const Reader& reader, ValueType& values,
+                       std::index_sequence<Index...>)
+    {
+        using element_type = typename std::decay<decltype(values[0])>::type;
+        (void) std::initializer_list<int>
+        {
+            (values[Index] = reader.template field<Index>().template
+                             as<element_type>(), 0)...
+        };
+    }
+};
+
+template<class Type, class BitNumbering, uint32_t... Sizes>
+const uint64_t bits<Type, BitNumbering, Sizes...>::size;
+
+/// Compile-time check that a field equals a value, see checked
+template<uint64_t Expected>
+struct eq
+{
+    template<class ValueType>
+    static bool check(const ValueType& value)
+    {
+        return static_cast<uint64_t>(value) == Expected;
+    }
+};
+
+/// Compile-time check that a field differs from a value, see checked
+template<uint64_t Expected>
+struct ne
+{
+    template<class ValueType>
+    static bool check(const ValueType& value)
+    {
+        return static_cast<uint64_t>(value) != Expected;
+    }
+};
+
+/// Compile-time check that a field is at most a value, see checked
+template<uint64_t Expected>
+struct le
+{
+    template<class ValueType>
+    static bool check(const ValueType& value)
+    {
+        return static_cast<uint64_t>(value) <= Expected;
+    }
+};
+
+/// Compile-time check that a field is at least a value, see checked
+template<uint64_t Expected>
+struct ge
+{
+    template<class ValueType>
+    static bool check(const ValueType& value)
+    {
+        return static_cast<uint64_t>(value) >= Expected;
+    }
+};
+
+/// Compile-time check that a field is in the range [Min, Max], see checked
+template<uint64_t Min, uint64_t Max>
+struct in_range
+{
+    static_assert(Min <= Max, "Min must not be larger than Max");
+
+    template<class ValueType>
+    static bool check(const ValueType& value)
+    {
+        return (static_cast<uint64_t>(value) - Min) <= (Max - Min);
+    }
+};
+
+/// Applies a check to the bit field at a given index of a bits descriptor,
+/// see checked
+template<uint32_t Index, class Check>
+struct element
+{
+    template<class ValueType>
+    static bool check(const ValueType& values)
+    {
+        return Check::check(values[Index]);
+    }
+};
+
+/// Layout descriptor of a field or bits descriptor whose decoded value must
+/// pass a number of checks, e.g.
+///
+///     bnb::checked<bnb::field<1>, bnb::eq<17>>
+///     bnb::checked<bnb::bits<bitter::u8, bitter::msb0, 4, 4>,
+///                  bnb::element<0, bnb::eq<4>>,
+///                  bnb::element<1, bnb::ge<5>>>
+///
+/// The checks of a layout are evaluated together after it has been decoded,
+/// see layout::check().
+template<class Field, class... Checks>
+struct checked : Field
+{
+    /// @param value The decoded value of the field
+    /// @return True if the value passes all the checks
+    template<class ValueType>
+    static bool check(const ValueType& value)
+    {
+        (void) value;
+        bool valid = true;
+        (void) std::initializer_list<int>
+        {
+            (valid &= Checks::check(value), 0)...
+        };
+        return valid;
+    }
+};
+
+/// Compile-time description of a fixed layout message consisting of a
+/// sequence of field and bits descriptors. The whole layout is read with a
+/// single bounds check, see stream_reader::read_layout().
+///
+/// As every field is decoded at a compile-time constant offset from the same
+/// pointer, the compiler is free to merge the loads of contiguous fields
+/// into wide loads. Likewise the checks of the checked fields are merged
+/// into a single branch, and the layout is written with a single bounds
+/// check, see stream_writer::write_layout().
+template<class... Fields>
+class layout
+{
+public:
+
+    /// The size of the layout in bytes
+    static const uint64_t size = detail::fields_size<Fields...>::value;
+
+    /// The tuple type the layout is decoded into
+    using value_type = std::tuple<typename Fields::value_type...>;
+
+public:
+
+    /// Decodes the layout
+    /// @param data Pointer to the bounds checked data of the layout
+    /// @param values The destination of the decoded fields. This can be a
+    ///        value_type or a tuple of references e.g. created by std::tie.
+    template<class Endianness, class Values>
+    static void decode(const uint8_t* data, Values&& values)
+    {
+        static_assert(
+            std::tuple_size<typename std::decay<Values>::type>::value ==
+            sizeof...(Fields), "The number of values must match the layout");
+
+        decode<Endianness>(data, values,
+                           std::make_index_sequence<sizeof...(Fields)>());
+    }
+
+    /// Encodes the layout
+    /// @param data Pointer to the bounds checked destination of the layout
+    /// @param values The values of the fields, a value_type or a tuple e.g.
+    ///        created by std::tie.
+    template<class Endianness, class Values>
+    static void encode(uint8_t* data, const Values& values)
+    {
+        static_assert(
+            std::tuple_size<Values>::value == sizeof...(Fields),
+            "The number of values must match the layout");
+
+        encode<Endianness>(data, values,
+                           std::make_index_sequence<sizeof...(Fields)>());
+    }
+
+    /// Checks the decoded values of the checked fields. The checks are
+    /// combined without short-circuiting, so the compiler can evaluate them
+    /// without a branch per field.
+    ///
+    /// @param values The decoded values, see decode()
+    /// @return True if all the values pass their checks
+    template<class Values>
+    static bool check(const Values& values)
+    {
+        return check(values, std::make_index_sequence<sizeof...(Fields)>());
+    }
+
+private:
+
+    template<class Endianness, class Values, std::size_t... Index>
+    static void decode(const uint8_t* data, Values& values,
+                       std::index_sequence<Index...>)
+    {
+        (void) std::initializer_list<int>
+        {
+            (Fields::template decode<Endianness>(
+                 data + detail::field_offset<Index, Fields...>::value,
+                 std::get<Index>(values)), 0)...
+        };
+    }
+
+    template<class Endianness, class Values, std::size_t... Index>
+    static void encode(uint8_t* data, const Values& values,
+                       std::index_sequence<Index...>)
+    {
+        (void) std::initializer_list<int>
+        {
+            (Fields::template encode<Endianness>(
+                 data + detail::field_offset<Index, Fields...>::value,
+                 std::get<Index>(values)), 0)...
+        };
+    }
+
+    template<class Values, std::size_t... Index>
+    static bool check(const Values& values, std::index_sequence<Index...>)
+    {
+        bool valid = true;
+        (void) std::initializer_list<int>
+        {
+            (valid &= Fields::check(std::get<Index>(values)), 0)...
+        };
+        return valid;
+    }
+};
+
+template<class... Fields>
+const uint64_t layout<Fields...>::size;
+}
@@ -0,0 +1,242 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <cerrno>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bnb
+{
+/// Options for how a file is mapped into memory
+struct mapped_file_options
+{
+    /// Advise the kernel that the file is read sequentially, which enables
+    /// aggressive read-ahead and early release of the pages read.
+    bool sequential = true;
+
+    /// Advise the kernel that the whole file will be needed soon, which
+    /// starts reading it in the background.
+    bool will_need = false;
+
+    /// Read the whole file into memory when it is mapped, where supported
+    /// (MAP_POPULATE). This increases the startup time but avoids page
+    /// faults while parsing.
+    bool populate = false;
+};
+
+/// A read-only memory mapping of a file. The file is not copied, pages are
+/// read in by the kernel as they are accessed.
+class mapped_file
+{
+public:
+
+    /// Maps a file into memory.
+    ///
+    /// @param path The path of the file
+    /// @param error The error code to set if the file could not be mapped,
+    ///              in which case the mapping is empty.
+    /// @param options The options for how the file is mapped
+    mapped_file(const std::string& path, std::error_code& error,
+                const mapped_file_options& options = mapped_file_options())
+    {
+        if (error)
+            return;
+
+        map(path, error, options);
+    }
+
+    /// Unmaps the file
+    ~mapped_file()
+    {
+        unmap();
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    /// @return A pointer to the mapped data
+    const uint8_t* data() const
+    {
+        return m_data;
+    }
+
+    /// @return The size of the mapped data in bytes
+    uint64_t size() const
+    {
+        return m_size;
+    }
+
+private:
+
+#if defined(_WIN32)
+
+    void map(const std::string& path, std::error_code& error,
+             const mapped_file_options& options)
+    {
+        DWORD flags = options.sequential ?
+            FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             nullptr, OPEN_EXISTING, flags, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            set_error(error);
+            return;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size))
+        {
+            set_error(error);
+            return;
+        }
+        if (size.QuadPart == 0)
+            return;
+
+        m_mapping = CreateFileMappingA(
+            m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping == nullptr)
+        {
+            set_error(error);
+            return;
+        }
+
+        void* data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            set_error(error);
+            return;
+        }
+
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = static_cast<uint64_t>(size.QuadPart);
+        m_mapped = true;
+
+        if (options.will_need || options.populate)
+        {
+            WIN32_MEMORY_RANGE_ENTRY range;
+            range.VirtualAddress = data;
+            range.NumberOfBytes = static_cast<SIZE_T>(m_size);
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+    }
+
+    void unmap()
+    {
+        if (m_mapped)
+            UnmapViewOfFile(m_data);
+        if (m_mapping != nullptr)
+            CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+    }
+
+    static void set_error(std::error_code& error)
+    {
+        error = std::error_code(
+            static_cast<int>(GetLastError()), std::system_category());
+    }
+
+#else
+
+    void map(const std::string& path, std::error_code& error,
+             const mapped_file_options& options)
+    {
+        m_file = ::open(path.c_str(), O_RDONLY);
+        if (m_file < 0)
+        {
+            set_error(error);
+            return;
+        }
+
+        struct stat status;
+        if (::fstat(m_file, &status) != 0)
+        {
+            set_error(error);
+            return;
+        }
+
+        // Empty files can't be mapped
+        if (status.st_size == 0)
+            return;
+
+        int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+        if (options.populate)
+            flags |= MAP_POPULATE;
+#endif
+
+        size_t size = static_cast<size_t>(status.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, flags, m_file, 0);
+        if (data == MAP_FAILED)
+        {
+            set_error(error);
+            return;
+        }
+
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = static_cast<uint64_t>(size);
+        m_mapped = true;
+
+#if defined(MADV_SEQUENTIAL) && defined(MADV_WILLNEED)
+        // The advice is only a hint, so failures are ignored
+        if (options.sequential)
+            ::madvise(data, size, MADV_SEQUENTIAL);
+        if (options.will_need)
+            ::madvise(data, size, MADV_WILLNEED);
+#endif
+    }
+
+    void unmap()
+    {
+        if (m_mapped)
+            ::munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+        if (m_file >= 0)
+            ::close(m_file);
+    }
+
+    static void set_error(std::error_code& error)
+    {
+        error = std::error_code(errno, std::system_category());
+    }
+
+#endif
+
+private:
+
+    /// Points to valid memory even when nothing is mapped
+    static const uint8_t* empty()
+    {
+        static const uint8_t data = 0;
+        return &data;
+    }
+
+private:
+
+#if defined(_WIN32)
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+    bool m_mapped = false;
+    const uint8_t* m_data = empty();
+    uint64_t m_size = 0;
+};
+}
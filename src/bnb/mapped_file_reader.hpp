@@ -0,0 +1,43 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#include "mapped_file.hpp"
+#include "stream_reader.hpp"
+
+namespace bnb
+{
+/// A stream reader over a memory mapped file. This allows parsing large
+/// files without reading them into memory first.
+template<class Endianness>
+class mapped_file_reader :
+    private mapped_file,
+    public stream_reader<Endianness>
+{
+public:
+
+    /// Constructs a stream reader over a memory mapped file.
+    ///
+    /// @param path The path of the file
+    /// @param error A reference to the error code to set if the file could
+    ///              not be mapped or an error happened while reading.
+    /// @param options The options for how the file is mapped
+    mapped_file_reader(
+        const std::string& path, std::error_code& error,
+        const mapped_file_options& options = mapped_file_options()) :
+        mapped_file(path, error, options),
+        stream_reader<Endianness>(
+            mapped_file::data(), mapped_file::size(), error)
+    { }
+
+    using stream_reader<Endianness>::data;
+    using stream_reader<Endianness>::size;
+};
+}
@@ -0,0 +1,73 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+
+#include "diagnostics.hpp"
+#include "stats.hpp"
+#include "status.hpp"
+
+namespace bnb
+{
+namespace detail
+{
+/// The state a reader passes on to the bit readers and validators it
+/// returns, i.e. the diagnostics sink, the stats and the position of the
+/// value. With the no_diagnostics and no_stats policies it is empty and all
+/// its functions compile away.
+///
+/// The Error is the type of the error state shared by the reader and the
+/// validators, std::error_code or status.
+template<class Diagnostics = no_diagnostics, class Stats = no_stats,
+         class Error = std::error_code>
+class reader_context :
+    public diagnostics_context<Diagnostics>,
+    public stats_context<Stats>
+{
+public:
+
+    /// The type of the error state
+    using error_type = Error;
+
+public:
+
+    reader_context() = default;
+
+    /// @param diagnostics The diagnostics sink
+    /// @param stats The stats
+    reader_context(const diagnostics_context<Diagnostics>& diagnostics,
+                   const stats_context<Stats>& stats) :
+        diagnostics_context<Diagnostics>(diagnostics),
+        stats_context<Stats>(stats)
+    { }
+
+    /// @param position The byte position of the value
+    /// @param bit_offset The bit offset of the value
+    /// @return A copy of this context for a value at the given position
+    reader_context at(uint64_t position, uint32_t bit_offset = 0) const
+    {
+        reader_context context = *this;
+        context.move_to(position, bit_offset);
+        return context;
+    }
+
+    /// Reports a failed read or validation to the diagnostics sink and
+    /// counts it in the stats
+    template<class Actual, class Expected>
+    void report(const Error& error, diagnostic_kind kind,
+                const Actual& actual, const Expected& expected,
+                const Expected& expected_max) const
+    {
+        diagnostics_context<Diagnostics>::report(
+            detail::to_error_code(error), kind, actual, expected,
+            expected_max);
+        stats_context<Stats>::count_failure(kind);
+    }
+};
+}
+}
@@ -0,0 +1,235 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "stream_reader.hpp"
+
+namespace bnb
+{
+/// The bytes of a single record found by split_records()
+struct record_span
+{
+    /// The pointer to the data of the record
+    const uint8_t* data;
+
+    /// The size of the record in bytes
+    uint64_t size;
+};
+
+/// Finds the boundaries of a sequence of length prefixed records, i.e. a
+/// length field of LengthBytes bytes followed by that number of bytes.
+///
+/// Only the length fields are read, the records are skipped. If the last
+/// record is truncated the error code of the reader is set and the records
+/// found up to that point are returned.
+///
+/// @param reader The reader positioned at the first record
+/// @return The records found
+template<uint8_t LengthBytes, class Endianness>
+std::vector<record_span> split_records(stream_reader<Endianness>& reader)
+{
+    std::vector<record_span> records;
+    while (!reader.error() && reader.remaining_size() > 0)
+    {
+        uint64_t length = 0;
+        reader.template read_bytes<LengthBytes>(length);
+        auto record = reader.skip(length);
+        if (reader.error())
+            break;
+
+        records.push_back({record.data(), record.size()});
+    }
+    return records;
+}
+
+namespace detail
+{
+/// The worker threads of parse_records(), which are joined when it returns
+/// or unwinds. The work queue is emptied first, so the workers finish their
+/// current records and stop instead of decoding the remaining ones.
+class record_workers
+{
+public:
+
+    /// Constructs an empty set of workers
+    /// @param next The index of the next record to decode
+    /// @param count The number of records
+    record_workers(std::atomic<uint64_t>& next, uint64_t count) :
+        m_next(next),
+        m_count(count)
+    { }
+
+    /// Stops the work and joins the worker threads
+    ~record_workers()
+    {
+        stop();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    record_workers(const record_workers&) = delete;
+    record_workers& operator=(const record_workers&) = delete;
+
+    /// Starts a worker thread
+    /// @param function The function run by the thread
+    template<class Function>
+    void start(Function&& function)
+    {
+        m_workers.emplace_back(std::forward<Function>(function));
+    }
+
+    /// Empties the work queue, so no more records are claimed
+    void stop()
+    {
+        m_next.store(m_count, std::memory_order_relaxed);
+    }
+
+    /// Stops the work because of an exception thrown by a worker thread,
+    /// which is rethrown on the calling thread by rethrow_failure()
+    /// @param failure The exception
+    void fail(std::exception_ptr failure)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stop();
+        if (!m_failure)
+            m_failure = failure;
+        m_failed.store(true, std::memory_order_release);
+    }
+
+    /// Rethrows the first exception thrown by a worker thread, if any
+    void rethrow_failure()
+    {
+        if (!m_failed.load(std::memory_order_acquire))
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::rethrow_exception(m_failure);
+    }
+
+private:
+
+    std::atomic<uint64_t>& m_next;
+    uint64_t m_count;
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::exception_ptr m_failure;
+    std::atomic<bool> m_failed{false};
+};
+}
+
+/// Decodes records in parallel and delivers the results in order.
+///
+/// Each record is decoded by a worker thread with its own stream_reader and
+/// error code. The results are delivered on the calling thread in the order
+/// of the records, as soon as all preceding records have been delivered.
+///
+/// The worker threads are started by each call and joined before it
+/// returns, rather than taken from a pool, so the library needs no pool
+/// object or executor interface. Starting a thread costs in the order of
+/// ten microseconds, which is small next to decoding a batch of thousands
+/// of records, so small batches should be gathered into larger ones or
+/// decoded with a single thread. Users of this header must link with the
+/// platform's thread library, e.g. Threads::Threads in CMake.
+///
+/// If decode or deliver throws, or a thread cannot be started, no more
+/// records are decoded, the worker threads are joined and the first
+/// exception is rethrown to the caller.
+///
+/// @param records The records to decode, e.g. found by split_records()
+/// @param decode Called as decode(stream_reader<Endianness>&) from the
+///        worker threads and returns the result of a record. The result type
+///        must be default constructible.
+/// @param deliver Called as deliver(index, result, error) on the calling
+///        thread for each record in order, where error is the error code of
+///        the reader after decoding.
+/// @param threads The number of threads to decode with, including the
+///        calling thread. 0 uses the number of hardware threads.
+template<class Endianness, class Decode, class Deliver>
+void parse_records(const std::vector<record_span>& records, Decode&& decode,
+                   Deliver&& deliver, uint32_t threads = 0)
+{
+    using result_type = typename std::decay<decltype(
+        decode(std::declval<stream_reader<Endianness>&>()))>::type;
+
+    // The number of records claimed by a thread at a time
+    const uint64_t chunk = 16;
+
+    const uint64_t count = records.size();
+
+    // Not a std::vector, which packs bool results so that threads writing
+    // neighbouring results would race
+    std::unique_ptr<result_type[]> results(new result_type[count]());
+    std::vector<std::error_code> errors(count);
+    std::vector<std::atomic<bool>> done(count);
+    std::atomic<uint64_t> next(0);
+
+    // Decodes the next chunk of records
+    // @return false if there are no records left
+    auto work = [&]()
+    {
+        uint64_t begin = next.fetch_add(chunk, std::memory_order_relaxed);
+        if (begin >= count)
+            return false;
+
+        uint64_t end = std::min(begin + chunk, count);
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            stream_reader<Endianness> reader(
+                records[i].data, records[i].size, errors[i]);
+            results[i] = decode(reader);
+            done[i].store(true, std::memory_order_release);
+        }
+        return true;
+    };
+
+    if (threads == 0)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+
+    // Declared after the state used by the work, which therefore outlives
+    // the workers
+    detail::record_workers workers(next, count);
+    for (uint32_t i = 1; i < std::min<uint64_t>(threads, count); ++i)
+    {
+        workers.start([&work, &workers]()
+        {
+            try
+            {
+                while (work())
+                { }
+            }
+            catch (...)
+            {
+                workers.fail(std::current_exception());
+            }
+        });
+    }
+
+    // Deliver the results in order, helping with the decoding while the
+    // next result is not ready
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        while (!done[i].load(std::memory_order_acquire))
+        {
+            workers.rethrow_failure();
+            if (!work())
+                std::this_thread::yield();
+        }
+        deliver(i, results[i], errors[i]);
+    }
+}
+}
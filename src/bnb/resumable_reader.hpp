@@ -0,0 +1,112 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <cassert>
+#include <endian/stream_reader.hpp>
+
+#include "error.hpp"
+#include "stream_reader.hpp"
+
+namespace bnb
+{
+/// A stream reader over the part of a stream which has been received so
+/// far, e.g. from a socket.
+///
+/// Reading past the end of the available data sets the
+/// bnb::error::need_more_data error code, which is distinct from the error
+/// codes set for malformed data. The parser can save its position with
+/// checkpoint() after each completed part of a message and, once more data
+/// has arrived, resume() from there. This way every part is only parsed
+/// once, regardless of how fragmented the message arrives.
+///
+/// Note, readers returned by skip() cover a fixed number of bytes, so for
+/// these reading past the end means the data is malformed and the usual
+/// error codes are set.
+template<class Endianness>
+class resumable_reader : public stream_reader<
+    Endianness, no_diagnostics, no_stats, std::error_code, true>
+{
+private:
+
+    /// The type of the underlying reader
+    using reader_type = stream_reader<
+        Endianness, no_diagnostics, no_stats, std::error_code, true>;
+
+public:
+
+    /// Constructs a resumable reader over the data available so far.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the available data
+    /// @param error A reference to the error code to set if an error happened
+    resumable_reader(const uint8_t* data, uint64_t size,
+                     std::error_code& error) :
+        reader_type(data, size, error)
+    {
+        this->attach();
+    }
+
+    /// Saves the current read position as the position to resume from.
+    /// Nothing is saved if the error code has been set.
+    void checkpoint()
+    {
+        if (this->m_error)
+            return;
+
+        m_checkpoint = this->m_stream.position();
+    }
+
+    /// @return The position saved by the last call to checkpoint()
+    uint64_t checkpoint_position() const
+    {
+        return m_checkpoint;
+    }
+
+    /// @return true if reading stopped because more data is needed
+    bool need_more_data() const
+    {
+        return this->m_error == bnb::error::need_more_data;
+    }
+
+    /// @return The size of the data needed to complete the read which
+    ///         failed, i.e. at least this many bytes must be available
+    ///         before resuming.
+    uint64_t needed_size() const
+    {
+        assert(need_more_data());
+        return this->last_needed_size();
+    }
+
+    /// Resumes reading from the last checkpoint over a new buffer, which
+    /// holds more of the stream. A need_more_data error is cleared, other
+    /// errors are kept as the data is malformed.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the available data
+    /// @param discarded The number of bytes dropped from the front of the
+    ///        buffer since the last call, at most the checkpoint position.
+    ///        This allows the consumed data to be released.
+    void resume(const uint8_t* data, uint64_t size, uint64_t discarded = 0)
+    {
+        assert(discarded <= m_checkpoint);
+
+        if (need_more_data())
+            this->m_error = std::error_code();
+
+        m_checkpoint -= discarded;
+        this->m_stream = endian::stream_reader<Endianness>(data, size);
+        this->seek(m_checkpoint);
+    }
+
+private:
+
+    /// The position to resume from
+    uint64_t m_checkpoint = 0;
+};
+}
@@ -0,0 +1,73 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+
+namespace bnb
+{
+namespace detail
+{
+/// The state of a reader over the part of a stream received so far, see
+/// resumable_reader. A stream_reader derives from it, so it is empty for the
+/// readers which are not resumable.
+///
+/// Only the reader the state was attached to is resumable, while the readers
+/// returned by its skip() cover a fixed number of bytes and are not.
+template<bool Resumable>
+class resume_state
+{
+public:
+
+    /// Makes accesses past the end of the data need more data
+    void attach()
+    {
+        m_attached = true;
+    }
+
+    /// Records an access past the end of the data.
+    ///
+    /// @param needed_size The size of the stream needed by the access
+    /// @return True if more data may complete the access, i.e. the
+    ///         bnb::error::need_more_data error code should be set
+    bool need_more_data(uint64_t needed_size) const
+    {
+        if (!m_attached)
+            return false;
+
+        m_needed_size = needed_size;
+        return true;
+    }
+
+    /// @return The size of the stream needed by the last access which
+    ///         needed more data
+    uint64_t last_needed_size() const
+    {
+        return m_needed_size;
+    }
+
+private:
+
+    /// Whether more data may become available
+    bool m_attached = false;
+
+    /// The size of the stream needed by the last access which needed more
+    /// data
+    mutable uint64_t m_needed_size = 0;
+};
+
+template<>
+class resume_state<false>
+{
+public:
+
+    bool need_more_data(uint64_t) const
+    {
+        return false;
+    }
+};
+}
+}
@@ -0,0 +1,305 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <cassert>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include "bit_reader.hpp"
+#include "error.hpp"
+#include "validator.hpp"
+
+namespace bnb
+{
+/// A contiguous part of a non-contiguous buffer, e.g. an iovec.
+struct segment
+{
+    /// The pointer to the data of the segment
+    const uint8_t* data;
+
+    /// The size of the segment in bytes
+    uint64_t size;
+};
+
+/// A reader with the API of stream_reader over a buffer split into a number
+/// of segments. Fields within a segment are read directly from the segment,
+/// only fields crossing a segment boundary are copied together.
+template<class Endianness>
+class segmented_reader
+{
+private:
+
+    /// The read position in the segments
+    struct cursor
+    {
+        /// The current segment
+        const segment* m_segment;
+
+        /// The read position in the current segment
+        const uint8_t* m_data;
+
+        /// The bytes available at the read position in the current segment
+        uint64_t m_available;
+
+        /// The bytes remaining in total
+        uint64_t m_remaining;
+
+        /// Moves to the start of the next segment
+        void next()
+        {
+            m_remaining -= m_available;
+            ++m_segment;
+            m_data = m_segment->data;
+            m_available = std::min(m_segment->size, m_remaining);
+        }
+
+        /// Moves the read position, the size must be at most m_remaining.
+        void advance(uint64_t size)
+        {
+            assert(size <= m_remaining);
+            while (size > m_available)
+            {
+                size -= m_available;
+                next();
+            }
+            m_data += size;
+            m_available -= size;
+            m_remaining -= size;
+        }
+
+        /// Copies data and moves the read position, the size must be at most
+        /// m_remaining.
+        void copy(uint8_t* data, uint64_t size)
+        {
+            assert(size <= m_remaining);
+            while (size > m_available)
+            {
+                if (m_available > 0)
+                    std::memcpy(data, m_data, m_available);
+                data += m_available;
+                size -= m_available;
+                next();
+            }
+            if (size > 0)
+                std::memcpy(data, m_data, size);
+            m_data += size;
+            m_available -= size;
+            m_remaining -= size;
+        }
+    };
+
+public:
+
+    /// Constructs a segmented reader.
+    ///
+    /// @param segments The pointer to the segments, they must outlive the
+    ///                 reader.
+    /// @param count The number of segments
+    /// @param error A reference to the error code to set if an error happened
+    segmented_reader(const segment* segments, uint64_t count,
+                     std::error_code& error) :
+        m_error(error)
+    {
+        m_size = 0;
+        for (uint64_t i = 0; i < count; ++i)
+            m_size += segments[i].size;
+
+        m_cursor.m_segment = segments;
+        m_cursor.m_data = count > 0 ? segments[0].data : nullptr;
+        m_cursor.m_available = count > 0 ? segments[0].size : 0;
+        m_cursor.m_remaining = m_size;
+    }
+
+    /// Reads from the stream and moves the read position.
+    ///
+    /// @param value reference to the value to be read.
+    template<uint8_t Bytes, class ValueType>
+    validator<ValueType> read_bytes(ValueType& value)
+    {
+        if (m_error)
+            return { value, m_error };
+
+        if (Bytes <= m_cursor.m_available)
+        {
+            Endianness::template get_bytes<Bytes, ValueType>(
+                value, m_cursor.m_data);
+            m_cursor.m_data += Bytes;
+            m_cursor.m_available -= Bytes;
+            m_cursor.m_remaining -= Bytes;
+            return { value, m_error };
+        }
+
+        if (Bytes > m_cursor.m_remaining)
+        {
+            m_error = bnb::make_error_code(bnb::error::truncated);
+            return { value, m_error };
+        }
+
+        uint8_t data[Bytes];
+        m_cursor.copy(data, Bytes);
+        Endianness::template get_bytes<Bytes, ValueType>(value, data);
+        return { value, m_error };
+    }
+
+    /// Reads from the stream and moves the read position.
+    template<uint8_t Bytes>
+    validator<uint64_t> read_bytes()
+    {
+        uint64_t value = 0;
+        return read_bytes<Bytes, uint64_t>(value);
+    }
+
+    /// Peeks in the stream without moving the read position.
+    ///
+    /// @param value reference to the value to be read.
+    /// @param offset number of bytes to offset the peeking with
+    template<uint8_t Bytes, class ValueType>
+    validator<ValueType> peek_bytes(ValueType& value, uint64_t offset=0) const
+    {
+        if (m_error)
+            return { value, m_error };
+
+        if (offset <= m_cursor.m_available &&
+            Bytes <= m_cursor.m_available - offset)
+        {
+            Endianness::template get_bytes<Bytes, ValueType>(
+                value, m_cursor.m_data + offset);
+            return { value, m_error };
+        }
+
+        if (offset > m_cursor.m_remaining ||
+            Bytes > m_cursor.m_remaining - offset)
+        {
+            m_error = bnb::make_error_code(bnb::error::truncated);
+            return { value, m_error };
+        }
+
+        cursor peek = m_cursor;
+        peek.advance(offset);
+        uint8_t data[Bytes];
+        peek.copy(data, Bytes);
+        Endianness::template get_bytes<Bytes, ValueType>(value, data);
+        return { value, m_error };
+    }
+
+    /// Peeks in the stream without moving the read position.
+    /// @param offset number of bytes to offset the peeking with
+    template<uint8_t Bytes>
+    validator<uint64_t> peek_bytes(uint64_t offset=0) const
+    {
+        uint64_t value = 0;
+        return peek_bytes<Bytes, uint64_t>(value, offset);
+    }
+
+    /// Reads raw bytes from the stream to fill a buffer.
+    ///
+    /// Note, that this function is provided only for convenience and
+    /// it does not perform any endian conversions.
+    ///
+    /// @param data The data pointer to fill into
+    /// @param size The number of bytes to fill.
+    void read(uint8_t* data, uint64_t size)
+    {
+        if (m_error)
+            return;
+
+        if (size > m_cursor.m_remaining)
+        {
+            m_error = bnb::make_error_code(bnb::error::truncated);
+            return;
+        }
+
+        m_cursor.copy(data, size);
+    }
+
+    /// Returns a Bit Reader covering a given number of bytes and
+    /// moves the read position.
+    /// @return A bit reader covering the number of bytes in the Type template.
+    template<class Type, class BitNumbering, uint32_t... Sizes>
+    bit_reader<Type, BitNumbering, Sizes...> read_bits()
+    {
+        using value_type = typename Type::type;
+        value_type value = 0;
+        read_bytes<Type::size, value_type>(value);
+        return bit_reader<Type, BitNumbering, Sizes...>(value, m_error);
+    }
+
+    /// Skips over a given number of bytes in the stream
+    ///
+    /// @param bytes_to_skip the bytes to skip
+    /// @return A segmented reader covering the skipped bytes.
+    segmented_reader<Endianness> skip(uint64_t bytes_to_skip)
+    {
+        if (m_error)
+            return *this;
+
+        if (bytes_to_skip > m_cursor.m_remaining)
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_seek);
+            return *this;
+        }
+
+        cursor skipped = m_cursor;
+        skipped.m_available = std::min(skipped.m_available, bytes_to_skip);
+        skipped.m_remaining = bytes_to_skip;
+        m_cursor.advance(bytes_to_skip);
+        return segmented_reader<Endianness>(skipped, m_error);
+    }
+
+    /// Gets the current read position in the stream
+    ///
+    /// @return the current position.
+    uint64_t position() const
+    {
+        assert(!m_error);
+        return m_size - m_cursor.m_remaining;
+    }
+
+    /// The remaining number of bytes in the stream
+    ///
+    /// @return the remaining number of bytes.
+    uint64_t remaining_size() const
+    {
+        assert(!m_error);
+        return m_cursor.m_remaining;
+    }
+
+    /// Gets the size of all the segments in bytes.
+    ///
+    /// @return the size of the segments
+    uint64_t size() const
+    {
+        return m_size;
+    }
+
+    /// Returns the error code
+    /// @return the error code
+    std::error_code error() const
+    {
+        return m_error;
+    }
+
+private:
+
+    /// Constructs a segmented reader covering the remaining bytes of a cursor
+    segmented_reader(const cursor& position, std::error_code& error) :
+        m_cursor(position),
+        m_size(position.m_remaining),
+        m_error(error)
+    { }
+
+private:
+
+    cursor m_cursor;
+    uint64_t m_size;
+    std::error_code& m_error;
+};
+}
@@ -0,0 +1,361 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "diagnostics.hpp"
+
+namespace bnb
+{
+namespace detail
+{
+/// The indices of the counters of reader_stats
+enum stats_counter
+{
+    stats_fields,
+    stats_bytes,
+    stats_peeks,
+    stats_skips,
+    stats_skipped_bytes,
+
+    /// The failures are counted per diagnostic_kind from here
+    stats_failures,
+    stats_counters = stats_failures + (uint32_t)diagnostic_kind::expect + 1
+};
+}
+
+/// The default stats policy, which doesn't count anything. All the stats
+/// code compiles away, so this has no cost.
+struct no_stats
+{ };
+
+/// A stats policy which counts the work done by the readers using it, e.g.
+/// one instance per protocol.
+///
+/// A custom policy is any class with the count functions of this class.
+class reader_stats
+{
+public:
+
+    /// Counts values read from the stream
+    /// @param bytes The number of bytes consumed
+    /// @param fields The number of fields decoded
+    void count_read(uint64_t bytes, uint64_t fields)
+    {
+        m_counters[detail::stats_bytes] += bytes;
+        m_counters[detail::stats_fields] += fields;
+    }
+
+    /// Counts a bit field decoded from a value already read
+    void count_field()
+    {
+        ++m_counters[detail::stats_fields];
+    }
+
+    /// Counts a peek
+    void count_peek()
+    {
+        ++m_counters[detail::stats_peeks];
+    }
+
+    /// Counts a skip
+    /// @param bytes The number of bytes skipped
+    void count_skip(uint64_t bytes)
+    {
+        ++m_counters[detail::stats_skips];
+        m_counters[detail::stats_skipped_bytes] += bytes;
+    }
+
+    /// Counts a failed read or validation
+    /// @param kind The check which failed
+    void count_failure(diagnostic_kind kind)
+    {
+        ++m_counters[detail::stats_failures + (uint32_t)kind];
+    }
+
+    /// @return The number of fields decoded
+    uint64_t fields() const
+    {
+        return m_counters[detail::stats_fields];
+    }
+
+    /// @return The number of bytes consumed by reads
+    uint64_t bytes() const
+    {
+        return m_counters[detail::stats_bytes];
+    }
+
+    /// @return The number of peeks
+    uint64_t peeks() const
+    {
+        return m_counters[detail::stats_peeks];
+    }
+
+    /// @return The number of skips
+    uint64_t skips() const
+    {
+        return m_counters[detail::stats_skips];
+    }
+
+    /// @return The number of bytes skipped
+    uint64_t skipped_bytes() const
+    {
+        return m_counters[detail::stats_skipped_bytes];
+    }
+
+    /// @param kind The check which failed
+    /// @return The number of failures of the check
+    uint64_t failures(diagnostic_kind kind) const
+    {
+        return m_counters[detail::stats_failures + (uint32_t)kind];
+    }
+
+    /// @return The total number of failures
+    uint64_t failures() const
+    {
+        uint64_t total = 0;
+        for (uint32_t i = detail::stats_failures;
+             i < detail::stats_counters; ++i)
+        {
+            total += m_counters[i];
+        }
+        return total;
+    }
+
+    /// Adds the counters of other stats to this
+    reader_stats& operator+=(const reader_stats& other)
+    {
+        for (uint32_t i = 0; i < detail::stats_counters; ++i)
+            m_counters[i] += other.m_counters[i];
+        return *this;
+    }
+
+    /// Sets all counters to zero
+    void clear()
+    {
+        std::fill(m_counters, m_counters + detail::stats_counters, 0);
+    }
+
+private:
+
+    friend class thread_stats;
+
+    uint64_t m_counters[detail::stats_counters] = {};
+};
+
+/// A stats policy which counts into counters owned by the calling thread,
+/// so readers on different threads never share a cache line. The counters of
+/// all threads are summed by collect().
+///
+/// The owning thread updates its counters with relaxed loads and stores,
+/// which compile to plain instructions, so only collect() synchronizes.
+///
+/// A thread_stats object counts into the counters of the thread which
+/// constructed it, so it must only be used by that thread.
+class thread_stats
+{
+public:
+
+    thread_stats() :
+        m_block(&local())
+    { }
+
+    void count_read(uint64_t bytes, uint64_t fields)
+    {
+        auto& counters = m_block->m_counters;
+        add(counters[detail::stats_bytes], bytes);
+        add(counters[detail::stats_fields], fields);
+    }
+
+    void count_field()
+    {
+        add(m_block->m_counters[detail::stats_fields], 1);
+    }
+
+    void count_peek()
+    {
+        add(m_block->m_counters[detail::stats_peeks], 1);
+    }
+
+    void count_skip(uint64_t bytes)
+    {
+        auto& counters = m_block->m_counters;
+        add(counters[detail::stats_skips], 1);
+        add(counters[detail::stats_skipped_bytes], bytes);
+    }
+
+    void count_failure(diagnostic_kind kind)
+    {
+        add(m_block->m_counters[detail::stats_failures + (uint32_t)kind], 1);
+    }
+
+    /// @return The sum of the counters of all threads, including threads
+    ///         which have exited
+    static reader_stats collect()
+    {
+        auto& all = registry();
+        std::lock_guard<std::mutex> lock(all.m_mutex);
+
+        reader_stats stats = all.m_exited;
+        for (const block* counters : all.m_blocks)
+            counters->add_to(stats);
+        return stats;
+    }
+
+private:
+
+    /// The counters of a thread, aligned to a cache line so they are not
+    /// shared with other threads
+    struct alignas(64) block
+    {
+        void add_to(reader_stats& stats) const
+        {
+            for (uint32_t i = 0; i < detail::stats_counters; ++i)
+            {
+                stats.m_counters[i] +=
+                    m_counters[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<uint64_t> m_counters[detail::stats_counters] = {};
+    };
+
+    /// The blocks of the running threads
+    struct blocks
+    {
+        std::mutex m_mutex;
+        std::vector<const block*> m_blocks;
+        reader_stats m_exited;
+    };
+
+    /// Registers the block of a thread for its lifetime
+    struct registration
+    {
+        registration()
+        {
+            auto& all = registry();
+            std::lock_guard<std::mutex> lock(all.m_mutex);
+            all.m_blocks.push_back(&m_block);
+        }
+
+        ~registration()
+        {
+            auto& all = registry();
+            std::lock_guard<std::mutex> lock(all.m_mutex);
+            m_block.add_to(all.m_exited);
+            all.m_blocks.erase(std::find(
+                all.m_blocks.begin(), all.m_blocks.end(), &m_block));
+        }
+
+        block m_block;
+    };
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    static block& local()
+    {
+        static thread_local registration counters;
+        return counters.m_block;
+    }
+
+    static blocks& registry()
+    {
+        static blocks all;
+        return all;
+    }
+
+private:
+
+    block* m_block;
+};
+
+namespace detail
+{
+/// The stats policy used by a reader and the validators it returns
+template<class Stats>
+class stats_context
+{
+public:
+
+    stats_context() = default;
+
+    /// @param stats The stats to count into
+    explicit stats_context(Stats& stats) :
+        m_stats(&stats)
+    { }
+
+    void count_read(uint64_t bytes, uint64_t fields) const
+    {
+        if (m_stats != nullptr)
+            m_stats->count_read(bytes, fields);
+    }
+
+    void count_field() const
+    {
+        if (m_stats != nullptr)
+            m_stats->count_field();
+    }
+
+    void count_peek() const
+    {
+        if (m_stats != nullptr)
+            m_stats->count_peek();
+    }
+
+    void count_skip(uint64_t bytes) const
+    {
+        if (m_stats != nullptr)
+            m_stats->count_skip(bytes);
+    }
+
+    void count_failure(diagnostic_kind kind) const
+    {
+        if (m_stats != nullptr)
+            m_stats->count_failure(kind);
+    }
+
+private:
+
+    Stats* m_stats = nullptr;
+};
+
+/// Without stats the context is empty and does nothing
+template<>
+class stats_context<no_stats>
+{
+public:
+
+    stats_context() = default;
+
+    explicit stats_context(no_stats&)
+    { }
+
+    void count_read(uint64_t, uint64_t) const
+    { }
+
+    void count_field() const
+    { }
+
+    void count_peek() const
+    { }
+
+    void count_skip(uint64_t) const
+    { }
+
+    void count_failure(diagnostic_kind) const
+    { }
+};
+}
+}
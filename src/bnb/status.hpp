@@ -0,0 +1,111 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <system_error>
+
+#include "error.hpp"
+
+namespace bnb
+{
+/// A compact error state, which can be used by the readers and validators
+/// instead of a std::error_code, see the Error parameter of stream_reader.
+///
+/// A std::error_code holds an int and a category pointer, and as the int may
+/// alias the integers being read, the compiler has to reload it after every
+/// store to a value. The status only holds a bnb::error, which can't alias
+/// the values, so the sticky error check of a parse loop can stay in a
+/// register. It is converted to a std::error_code with error_code() once
+/// the parsing is done.
+///
+/// The readers, sub-readers and validators still reference the status
+/// owned by the caller, as they do a std::error_code, rather than holding it
+/// by value. Holding it in the reader would give every sub-reader and
+/// validator its own error state, or a pointer back to the owning reader,
+/// and the readers would no longer share one state with the caller. The
+/// reference costs no more than before. The gain comes from the pointee not
+/// aliasing the values: once the compiler knows the stores to the values
+/// can't change it, the indirect load of the error is hoisted out of the
+/// loop like an in-object field would be.
+class status
+{
+public:
+
+    /// @return True if an error has been set
+    explicit operator bool() const
+    {
+        return m_error != bnb::error();
+    }
+
+    /// Sets the error
+    /// @param error The error to set
+    void set(bnb::error error)
+    {
+        m_error = error;
+    }
+
+    /// @return The error, or bnb::error() if no error has been set
+    bnb::error value() const
+    {
+        return m_error;
+    }
+
+    /// @return The error as an error code
+    std::error_code error_code() const
+    {
+        if (m_error == bnb::error())
+            return std::error_code();
+        return bnb::make_error_code(m_error);
+    }
+
+    /// Clears the error
+    void clear()
+    {
+        m_error = bnb::error();
+    }
+
+    /// @return True if the status holds the error
+    friend bool operator==(const status& status, bnb::error error)
+    {
+        return status.m_error == error;
+    }
+
+    /// @return True if the status doesn't hold the error
+    friend bool operator!=(const status& status, bnb::error error)
+    {
+        return status.m_error != error;
+    }
+
+private:
+
+    bnb::error m_error = bnb::error();
+};
+
+namespace detail
+{
+/// Sets an error in an error state
+inline void set_error(std::error_code& state, bnb::error error)
+{
+    state = bnb::make_error_code(error);
+}
+
+inline void set_error(status& state, bnb::error error)
+{
+    state.set(error);
+}
+
+/// @return The error code of an error state
+inline const std::error_code& to_error_code(const std::error_code& state)
+{
+    return state;
+}
+
+inline std::error_code to_error_code(const status& state)
+{
+    return state.error_code();
+}
+}
+}
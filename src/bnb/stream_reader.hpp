@@ -8,18 +8,52 @@
 #include <cstdint>
 #include <system_error>
 #include <cassert>
+#include <tuple>
+#include <utility>
 #include <endian/stream_reader.hpp>
 #include <endian/big_endian.hpp>
 #include <endian/little_endian.hpp>
 
+#include "array_validator.hpp"
 #include "bit_reader.hpp"
+#include "decode_array.hpp"
+#include "reader_context.hpp"
+#include "resume_state.hpp"
+#include "error.hpp"
+#include "find.hpp"
 #include "validator.hpp"
+#include "varint.hpp"
+#include "view.hpp"
+#include "window_reader.hpp"
 
 namespace bnb
 {
-template<class Endianness>
-class stream_reader
+/// Reads values from a buffer.
+///
+/// The Diagnostics policy selects where errors are reported, see
+/// diagnostic_recorder. The Stats policy selects where the work done is
+/// counted, see reader_stats and thread_stats. With the default
+/// no_diagnostics and no_stats policies only the error code is set and the
+/// policy code compiles away.
+///
+/// The Error selects the type of the error state shared by the reader and
+/// the validators it returns. The default is a std::error_code, while status
+/// is a compact state which lets the compiler keep the sticky error check of
+/// a parse loop in a register.
+///
+/// Resumable is only set by resumable_reader. Other readers have no state
+/// or branches for resuming.
+template<class Endianness, class Diagnostics = no_diagnostics,
+         class Stats = no_stats, class Error = std::error_code,
+         bool Resumable = false>
+class stream_reader : protected detail::resume_state<Resumable>
 {
+private:
+
+    /// The policy state, i.e. the diagnostics sink, the stats, the position
+    /// of this reader's data in the stream and the current field name
+    using context_type = detail::reader_context<Diagnostics, Stats, Error>;
+
 public:
 
     /// Constructs a stream reader over a pre-allocated buffer.
@@ -27,34 +61,93 @@ public:
     /// @param data The pointer to the data.
     /// @param size The size of the allocated data
     /// @param error A reference to the error code to set if an error happened
-    stream_reader(const uint8_t* data, uint64_t size, std::error_code& error) :
+    stream_reader(const uint8_t* data, uint64_t size, Error& error) :
         m_stream(data, size),
         m_error(error)
     { }
 
+    /// Constructs a stream reader which reports errors to a diagnostics sink.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the allocated data
+    /// @param error A reference to the error code to set if an error happened
+    /// @param diagnostics The sink to report errors to. It must outlive the
+    ///        reader and the validators it returns.
+    stream_reader(const uint8_t* data, uint64_t size, Error& error,
+                  Diagnostics& diagnostics) :
+        m_stream(data, size),
+        m_error(error),
+        m_context(detail::diagnostics_context<Diagnostics>(diagnostics),
+                  detail::stats_context<Stats>())
+    { }
+
+    /// Constructs a stream reader which counts its work in stats.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the allocated data
+    /// @param error A reference to the error code to set if an error happened
+    /// @param stats The stats to count into. It must outlive the reader and
+    ///        the validators it returns.
+    stream_reader(const uint8_t* data, uint64_t size, Error& error,
+                  Stats& stats) :
+        m_stream(data, size),
+        m_error(error),
+        m_context(detail::diagnostics_context<Diagnostics>(),
+                  detail::stats_context<Stats>(stats))
+    { }
+
+    /// Constructs a stream reader with both a diagnostics sink and stats.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the allocated data
+    /// @param error A reference to the error code to set if an error happened
+    /// @param diagnostics The sink to report errors to
+    /// @param stats The stats to count into
+    stream_reader(const uint8_t* data, uint64_t size, Error& error,
+                  Diagnostics& diagnostics, Stats& stats) :
+        m_stream(data, size),
+        m_error(error),
+        m_context(detail::diagnostics_context<Diagnostics>(diagnostics),
+                  detail::stats_context<Stats>(stats))
+    { }
+
+    /// Names the values read from now on in the reported diagnostics.
+    ///
+    /// @param name The name of the field, or nullptr. The string must
+    ///        outlive the reader.
+    /// @return A reference to this reader
+    stream_reader& field(const char* name)
+    {
+        m_context.name(name);
+        return *this;
+    }
+
     /// Reads from the stream and moves the read position.
     ///
     /// @param value reference to the value to be read.
     template<uint8_t Bytes, class ValueType>
-    validator<ValueType> read_bytes(ValueType& value)
+    validator<ValueType, context_type> read_bytes(ValueType& value)
     {
+        auto context = value_context(0);
+
         if (m_error)
-            return { value, m_error };
+            return { value, m_error, context };
 
         if (Bytes > m_stream.remaining_size())
         {
-            m_error = std::make_error_code(std::errc::result_out_of_range);
-            return { value, m_error };
+            out_of_bounds(0, Bytes, bnb::error::truncated);
+            return { value, m_error, context };
         }
         m_stream.template read_bytes<Bytes, ValueType>(value);
-        return { value, m_error };
+        m_context.count_read(Bytes, 1);
+        return { value, m_error, context };
     }
 
     /// Reads from the stream and moves the read position.
     template<uint8_t Bytes>
-    validator<uint64_t> read_bytes()
+    validator<uint64_t, context_type> read_bytes()
     {
-        uint64_t value;
+        uint64_t value = 0;
         return read_bytes<Bytes, uint64_t>(value);
     }
 
@@ -63,29 +156,147 @@ public:
     /// @param value reference to the value to be read.
     /// @param offset number of bytes to offset the peeking with
     template<uint8_t Bytes, class ValueType>
-    validator<ValueType> peek_bytes(ValueType& value, uint64_t offset=0) const
+    validator<ValueType, context_type> peek_bytes(
+        ValueType& value, uint64_t offset=0) const
     {
+        auto context = value_context(offset);
+
         if (m_error)
-            return { value, m_error };
+            return { value, m_error, context };
 
-        if (Bytes > m_stream.remaining_size() - offset)
+        // Check the offset first, so the subtraction can't wrap around
+        if (offset > m_stream.remaining_size() ||
+            Bytes > m_stream.remaining_size() - offset)
         {
-            m_error = std::make_error_code(std::errc::result_out_of_range);
-            return { value, m_error };
+            out_of_bounds(offset, Bytes, bnb::error::truncated);
+            return { value, m_error, context };
         }
         m_stream.template peek_bytes<Bytes, ValueType>(value, offset);
-        return { value, m_error };
+        m_context.count_peek();
+        return { value, m_error, context };
     }
 
     /// Peeks in the stream without moving the read position.
     /// @param offset number of bytes to offset the peeking with
     template<uint8_t Bytes>
-    validator<uint64_t> peek_bytes(uint64_t offset=0) const
+    validator<uint64_t, context_type> peek_bytes(uint64_t offset=0) const
     {
         uint64_t value = 0;
         return peek_bytes<Bytes, uint64_t>(value, offset);
     }
 
+    /// Reads an array of values from the stream and moves the read position.
+    ///
+    /// The bounds are checked once for the whole array, see decode_array()
+    /// for how the values are decoded.
+    ///
+    /// @param values Pointer to room for count values. Nothing will be read
+    ///               if the error code has been set.
+    /// @param count The number of values to read
+    /// @return A validator which can check every value read.
+    template<uint8_t Bytes, class ValueType>
+    array_validator<ValueType, Error> read_array(
+        ValueType* values, uint64_t count)
+    {
+        if (m_error)
+            return { values, 0, m_error };
+
+        if (count > m_stream.remaining_size() / Bytes)
+        {
+            out_of_bounds(0, saturating_multiply(count, Bytes),
+                          bnb::error::truncated);
+            return { values, 0, m_error };
+        }
+
+        decode_array<Endianness, Bytes>(
+            m_stream.remaining_data(), values, count);
+        m_stream.skip(count * Bytes);
+        m_context.count_read(count * Bytes, count);
+        return { values, count, m_error };
+    }
+
+    /// Peeks an array of values in the stream without moving the read
+    /// position.
+    ///
+    /// @param values Pointer to room for count values. Nothing will be read
+    ///               if the error code has been set.
+    /// @param count The number of values to read
+    /// @param offset number of bytes to offset the peeking with
+    /// @return A validator which can check every value read.
+    template<uint8_t Bytes, class ValueType>
+    array_validator<ValueType, Error> peek_array(
+        ValueType* values, uint64_t count, uint64_t offset=0) const
+    {
+        if (m_error)
+            return { values, 0, m_error };
+
+        if (offset > m_stream.remaining_size() ||
+            count > (m_stream.remaining_size() - offset) / Bytes)
+        {
+            out_of_bounds(offset, saturating_multiply(count, Bytes),
+                          bnb::error::truncated);
+            return { values, 0, m_error };
+        }
+
+        decode_array<Endianness, Bytes>(
+            m_stream.remaining_data() + offset, values, count);
+        m_context.count_peek();
+        return { values, count, m_error };
+    }
+
+    /// Reads a variable-length integer from the stream and moves the read
+    /// position.
+    ///
+    /// The error code is set if the data is truncated, if the encoding is
+    /// invalid or overlong, or if the value doesn't fit in the ValueType.
+    ///
+    /// @param value reference to the value to be read.
+    /// @tparam Format The encoding of the integer e.g. leb128 or quic_varint
+    template<class Format, class ValueType>
+    validator<ValueType, context_type> read_varint(ValueType& value)
+    {
+        auto context = value_context(0);
+
+        if (m_error)
+            return { value, m_error, context };
+
+        uint64_t decoded = 0;
+        uint64_t size = Format::decode(
+            m_stream.remaining_data(), m_stream.remaining_size(), decoded);
+
+        if (size > m_stream.remaining_size())
+        {
+            out_of_bounds(0, size, bnb::error::truncated);
+            return { value, m_error, context };
+        }
+        if (size == 0)
+        {
+            detail::set_error(m_error, bnb::error::invalid_varint);
+            context.report(m_error, diagnostic_kind::read, 0U, 0U, 0U);
+            return { value, m_error, context };
+        }
+        if (decoded != (uint64_t)(ValueType)decoded)
+        {
+            detail::set_error(m_error, bnb::error::value_too_large);
+            context.report(m_error, diagnostic_kind::read, decoded, 0U, 0U);
+            return { value, m_error, context };
+        }
+
+        m_stream.skip(size);
+        m_context.count_read(size, 1);
+        value = (ValueType)decoded;
+        return { value, m_error, context };
+    }
+
+    /// Reads a variable-length integer from the stream and moves the read
+    /// position.
+    template<class Format>
+    validator<uint64_t, context_type> read_varint()
+    {
+        uint64_t value = 0;
+        return read_varint<Format, uint64_t>(value);
+    }
+
     /// Reads raw bytes from the stream to fill a buffer represented by
     /// a mutable storage object.
     ///
@@ -101,36 +312,136 @@ public:
 
         if (size > m_stream.remaining_size())
         {
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            out_of_bounds(0, size, bnb::error::truncated);
             return;
         }
 
         m_stream.read(data, size);
+        m_context.count_read(size, 1);
         return;
     }
 
+    /// Returns a view of bytes in the stream and moves the read position.
+    /// Unlike read() the bytes are not copied.
+    ///
+    /// @param size The number of bytes to view
+    /// @return A view of the bytes, which is empty if the error code has
+    ///         been set.
+    view read_view(uint64_t size)
+    {
+        if (m_error)
+            return view();
+
+        if (size > m_stream.remaining_size())
+        {
+            out_of_bounds(0, size, bnb::error::truncated);
+            return view();
+        }
+
+        view bytes(m_stream.remaining_data(), size);
+        m_stream.skip(size);
+        m_context.count_read(size, 1);
+        return bytes;
+    }
+
+    /// Reads a length field of LengthBytes bytes and returns a view of that
+    /// number of bytes following it. Moves the read position past both.
+    ///
+    /// @return A view of the bytes, which is empty if the error code has
+    ///         been set.
+    template<uint8_t LengthBytes>
+    view read_length_prefixed()
+    {
+        uint64_t length = 0;
+        read_bytes<LengthBytes>(length);
+        return read_view(length);
+    }
+
     /// Returns a Bit Reader covering a given number of bytes and
     /// moves the read position.
     /// @return A bit reader covering the number of bytes in the Type template.
     template<class Type, class BitNumbering, uint32_t... Sizes>
-    bit_reader<Type, BitNumbering, Sizes...> read_bits()
+    basic_bit_reader<context_type, Type, BitNumbering, Sizes...> read_bits()
     {
+        using reader_type =
+            basic_bit_reader<context_type, Type, BitNumbering, Sizes...>;
         using value_type = typename Type::type;
         value_type value = 0;
+        auto context = value_context(0);
 
         if (m_error)
         {
-            return bit_reader<Type, BitNumbering, Sizes...>(value, m_error);
+            return reader_type(value, m_error, context);
         }
 
         if (Type::size > m_stream.remaining_size())
         {
-            m_error = std::make_error_code(std::errc::result_out_of_range);
-            return bit_reader<Type, BitNumbering, Sizes...>(value, m_error);
+            out_of_bounds(0, Type::size, bnb::error::truncated);
+            return reader_type(value, m_error, context);
         }
 
         m_stream.template read_bytes<Type::size, value_type>(value);
-        return bit_reader<Type, BitNumbering, Sizes...>(value, m_error);
+        m_context.count_read(Type::size, 0);
+        return reader_type(value, m_error, context);
+    }
+
+    /// Checks that a given number of bytes are available in the stream and
+    /// moves the read position past them.
+    ///
+    /// The returned window reader only checks the bounds of its fixed size
+    /// reads with asserts, so a fixed layout can be read with a single bounds
+    /// check. If the bytes are not available the error code is set and the
+    /// returned window is empty.
+    ///
+    /// @param size the number of bytes required
+    /// @return A window reader covering the required bytes.
+    window_reader<Endianness, Error> require(uint64_t size)
+    {
+        using window_type = window_reader<Endianness, Error>;
+
+        if (m_error)
+            return window_type(m_stream.data(), 0, m_error);
+
+        if (size > m_stream.remaining_size())
+        {
+            out_of_bounds(0, size, bnb::error::truncated);
+            return window_type(m_stream.data(), 0, m_error);
+        }
+
+        auto remaining_data = m_stream.remaining_data();
+        m_stream.skip(size);
+        m_context.count_read(size, 0);
+        return window_type(remaining_data, size, m_error);
+    }
+
+    /// Reads a fixed layout message with a single bounds check and moves the
+    /// read position past it.
+    ///
+    /// The checks of the checked fields are evaluated together once the
+    /// fields are decoded, see layout::check(). If any of them fail the
+    /// error code is set to bnb::error::unexpected_value, and the decoded
+    /// values are left in the destination.
+    ///
+    /// @param values The destination of the decoded fields, see
+    ///        layout::decode(). Nothing will be read if the error code has
+    ///        been set.
+    template<class Layout, class Values>
+    void read_layout(Values&& values)
+    {
+        auto context = value_context(0);
+        auto window = require(Layout::size);
+        if (m_error)
+            return;
+
+        Layout::template decode<Endianness>(window.data(), values);
+        m_context.count_read(
+            0, std::tuple_size<typename Layout::value_type>::value);
+
+        if (!Layout::check(values))
+        {
+            detail::set_error(m_error, bnb::error::unexpected_value);
+            context.report(m_error, diagnostic_kind::expect, 0U, 0U, 0U);
+        }
     }
 
     /// Changes the current read/write position in the stream. The
@@ -145,7 +456,8 @@ public:
 
         if (new_position > m_stream.size())
         {
-            m_error = std::make_error_code(std::errc::invalid_seek);
+            out_of_bounds(new_position - m_stream.position(), 0,
+                          bnb::error::invalid_seek);
             return;
         }
 
@@ -155,21 +467,121 @@ public:
     /// Skips over a given number of bytes in the stream
     ///
     /// @param bytes_to_skip the bytes to skip
-    stream_reader<Endianness> skip(uint64_t bytes_to_skip)
+    stream_reader skip(uint64_t bytes_to_skip)
     {
         if (m_error)
             return *this;
 
         if (bytes_to_skip > m_stream.remaining_size())
         {
-            m_error = std::make_error_code(std::errc::invalid_seek);
+            out_of_bounds(0, bytes_to_skip, bnb::error::invalid_seek);
             return *this;
         }
 
         auto remaining_data = m_stream.remaining_data();
+        auto context = value_context(0);
         m_stream.skip(bytes_to_skip);
-        return stream_reader<Endianness>(
-            remaining_data, bytes_to_skip, m_error);
+        m_context.count_skip(bytes_to_skip);
+        return stream_reader(remaining_data, bytes_to_skip, m_error, context);
+    }
+
+    /// Finds the first occurrence of a pattern from the read position,
+    /// without moving the read position.
+    ///
+    /// @param pattern The pointer to the pattern, e.g. a sync word
+    /// @param pattern_size The size of the pattern. An empty pattern is
+    ///        found at offset 0.
+    /// @param offset The offset of the pattern from the read position
+    /// @return True if the pattern was found. Not finding the pattern is not
+    ///         an error.
+    bool find(const uint8_t* pattern, uint64_t pattern_size,
+              uint64_t& offset) const
+    {
+        if (m_error)
+            return false;
+
+        if (pattern_size == 0)
+        {
+            offset = 0;
+            return true;
+        }
+
+        auto remaining_data = m_stream.remaining_data();
+        auto match = detail::find_pattern(
+            remaining_data, m_stream.remaining_size(), pattern, pattern_size);
+        if (match == nullptr)
+            return false;
+
+        offset = match - remaining_data;
+        return true;
+    }
+
+    /// Finds the first occurrence of a byte from the read position, without
+    /// moving the read position.
+    ///
+    /// @param byte The byte, e.g. the 0x47 sync byte of MPEG-TS
+    /// @param offset The offset of the byte from the read position
+    /// @return True if the byte was found
+    bool find(uint8_t byte, uint64_t& offset) const
+    {
+        if (m_error)
+            return false;
+
+        auto remaining_data = m_stream.remaining_data();
+        auto match = detail::find_byte(
+            remaining_data, m_stream.remaining_size(), byte);
+        if (match == nullptr)
+            return false;
+
+        offset = match - remaining_data;
+        return true;
+    }
+
+    /// Moves the read position to the first occurrence of a pattern, e.g.
+    /// to resynchronize after corrupted data. The search uses memchr, so it
+    /// runs at close to memory bandwidth.
+    ///
+    /// @param pattern The pointer to the pattern
+    /// @param pattern_size The size of the pattern. An empty pattern is
+    ///        found at the read position.
+    /// @return True if the pattern was found. Otherwise the read position is
+    ///         not moved.
+    bool seek_to(const uint8_t* pattern, uint64_t pattern_size)
+    {
+        uint64_t offset = 0;
+        if (!find(pattern, pattern_size, offset))
+            return false;
+
+        m_stream.skip(offset);
+        m_context.count_skip(offset);
+        return true;
+    }
+
+    /// Moves the read position to the first occurrence of a byte.
+    ///
+    /// @param byte The byte to find
+    /// @return True if the byte was found. Otherwise the read position is
+    ///         not moved.
+    bool seek_to(uint8_t byte)
+    {
+        uint64_t offset = 0;
+        if (!find(byte, offset))
+            return false;
+
+        m_stream.skip(offset);
+        m_context.count_skip(offset);
+        return true;
+    }
+
+    /// Moves the read position to the next 0x000001 start code, see
+    /// bnb::start_code. A four byte start code 0x00000001 is found at its
+    /// second byte.
+    ///
+    /// @return True if a start code was found. Otherwise the read position
+    ///         is not moved.
+    bool seek_to_start_code()
+    {
+        return seek_to(start_code, sizeof(start_code));
     }
 
     /// A pointer to the stream's data at the current position.
@@ -220,12 +632,67 @@ public:
     /// @return the error code
     std::error_code error() const
     {
-        return m_error;
+        return detail::to_error_code(m_error);
     }
 
 private:
 
+    /// Constructs a sub-reader, see skip().
+    stream_reader(const uint8_t* data, uint64_t size, Error& error,
+                  const context_type& context) :
+        m_stream(data, size),
+        m_error(error),
+        m_context(context)
+    { }
+
+    /// @param offset The offset from the read position of a value
+    /// @return The diagnostics state of the value
+    context_type value_context(uint64_t offset) const
+    {
+        return m_context.at(saturating_add(
+            m_context.position() + m_stream.position(), offset));
+    }
+
+    /// Sets the error code for an access which exceeds the stream.
+    ///
+    /// @param offset The offset from the read position of the access
+    /// @param bytes The number of bytes accessed
+    /// @param code The error code to set if the stream is not resumable
+    void out_of_bounds(uint64_t offset, uint64_t bytes, bnb::error code) const
+    {
+        if (this->need_more_data(saturating_add(
+                saturating_add(m_stream.position(), offset), bytes)))
+        {
+            detail::set_error(m_error, bnb::error::need_more_data);
+            return;
+        }
+
+        detail::set_error(m_error, code);
+
+        uint64_t available = offset < m_stream.remaining_size() ?
+            m_stream.remaining_size() - offset : 0;
+        value_context(offset).report(
+            m_error, diagnostic_kind::read, available, bytes, bytes);
+    }
+
+    /// @return The sum of two values, or the maximum value on overflow
+    static uint64_t saturating_add(uint64_t a, uint64_t b)
+    {
+        return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+    }
+
+    /// @return The product of two values, or the maximum value on overflow
+    static uint64_t saturating_multiply(uint64_t a, uint64_t b)
+    {
+        return b != 0 && a > UINT64_MAX / b ? UINT64_MAX : a * b;
+    }
+
+protected:
+
     endian::stream_reader<Endianness> m_stream;
-    std::error_code& m_error;
+    Error& m_error;
+
+    /// The policy state, which is empty without diagnostics and stats
+    context_type m_context;
 };
 }
@@ -0,0 +1,226 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <cassert>
+#include <endian/stream_writer.hpp>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include "bit_writer.hpp"
+#include "error.hpp"
+
+namespace bnb
+{
+template<class Endianness>
+class stream_writer
+{
+public:
+
+    /// Constructs a stream writer over a pre-allocated buffer.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the allocated data
+    /// @param error A reference to the error code to set if an error happened
+    stream_writer(uint8_t* data, uint64_t size, std::error_code& error) :
+        m_stream(data, size),
+        m_error(error)
+    { }
+
+    /// Writes to the stream and moves the write position.
+    ///
+    /// @param value the value to be written. Nothing will be written if the
+    ///              error code has been set.
+    template<uint8_t Bytes, class ValueType>
+    void write_bytes(ValueType value)
+    {
+        if (m_error)
+            return;
+
+        if (Bytes > m_stream.remaining_size())
+        {
+            m_error = bnb::make_error_code(bnb::error::truncated);
+            return;
+        }
+        m_stream.template write_bytes<Bytes, ValueType>(value);
+    }
+
+    /// Writes raw bytes to the stream from a buffer.
+    ///
+    /// Note, that this function is provided only for convenience and
+    /// it does not perform any endian conversions.
+    ///
+    /// @param data The data pointer to copy from
+    /// @param size The number of bytes to write.
+    void write(const uint8_t* data, uint64_t size)
+    {
+        if (m_error)
+            return;
+
+        if (size > m_stream.remaining_size())
+        {
+            m_error = bnb::make_error_code(bnb::error::truncated);
+            return;
+        }
+
+        m_stream.write(data, size);
+    }
+
+    /// Returns a Bit Writer covering a given number of bytes and
+    /// moves the write position. The covered bytes are zeroed, the fields
+    /// are packed into the buffer as they are set on the bit writer.
+    /// @return A bit writer covering the number of bytes in the Type template.
+    template<class Type, class BitNumbering, uint32_t... Sizes>
+    bit_writer<Endianness, Type, BitNumbering, Sizes...> write_bits()
+    {
+        using writer_type =
+            bit_writer<Endianness, Type, BitNumbering, Sizes...>;
+        using value_type = typename Type::type;
+
+        if (m_error)
+            return writer_type(nullptr, m_error);
+
+        if (Type::size > m_stream.remaining_size())
+        {
+            m_error = bnb::make_error_code(bnb::error::truncated);
+            return writer_type(nullptr, m_error);
+        }
+
+        uint8_t* data = m_stream.remaining_data();
+        m_stream.template write_bytes<Type::size, value_type>(0);
+        return writer_type(data, m_error);
+    }
+
+    /// Writes a fixed layout message with a single bounds check and moves
+    /// the write position past it.
+    ///
+    /// The error code is set to bnb::error::truncated if the layout doesn't
+    /// fit in the remaining buffer, and to bnb::error::unexpected_value if
+    /// the values fail the checks of the layout, as with read_layout().
+    ///
+    /// @param values The values of the fields, see layout::encode(). Nothing
+    ///        will be written if the error code has been set.
+    template<class Layout, class Values>
+    void write_layout(const Values& values)
+    {
+        if (m_error)
+            return;
+
+        if (Layout::size > m_stream.remaining_size())
+        {
+            m_error = bnb::make_error_code(bnb::error::truncated);
+            return;
+        }
+
+        if (!Layout::check(values))
+        {
+            m_error = bnb::make_error_code(bnb::error::unexpected_value);
+            return;
+        }
+
+        Layout::template encode<Endianness>(m_stream.remaining_data(), values);
+        m_stream.skip(Layout::size);
+    }
+
+    /// Changes the current write position in the stream. The
+    /// position is absolute i.e. it is always relative to the
+    /// beginning of the buffer which is position 0.
+    ///
+    /// @param new_position the new position
+    void seek(uint64_t new_position)
+    {
+        if (m_error)
+            return;
+
+        if (new_position > m_stream.size())
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_seek);
+            return;
+        }
+
+        m_stream.seek(new_position);
+    }
+
+    /// Skips over a given number of bytes in the stream.
+    ///
+    /// @param bytes_to_skip the bytes to skip
+    /// @return A stream writer covering the skipped bytes, this can be used
+    ///         for filling in e.g. a length field once it is known.
+    stream_writer<Endianness> skip(uint64_t bytes_to_skip)
+    {
+        if (m_error)
+            return *this;
+
+        if (bytes_to_skip > m_stream.remaining_size())
+        {
+            m_error = bnb::make_error_code(bnb::error::invalid_seek);
+            return *this;
+        }
+
+        auto remaining_data = m_stream.remaining_data();
+        m_stream.skip(bytes_to_skip);
+        return stream_writer<Endianness>(
+            remaining_data, bytes_to_skip, m_error);
+    }
+
+    /// A pointer to the stream's data at the current position.
+    ///
+    /// @return pointer to the stream's data at the current position.
+    uint8_t* remaining_data() const
+    {
+        assert(!m_error);
+        return m_stream.remaining_data();
+    }
+
+    /// Gets the current write position in the stream
+    ///
+    /// @return the current position.
+    uint64_t position() const
+    {
+        assert(!m_error);
+        return m_stream.position();
+    }
+
+    /// The remaining number of bytes in the stream
+    ///
+    /// @return the remaining number of bytes.
+    uint64_t remaining_size() const
+    {
+        assert(!m_error);
+        return m_stream.remaining_size();
+    }
+
+    /// A pointer to the stream's data.
+    ///
+    /// @return pointer to the stream's data.
+    uint8_t* data() const
+    {
+        return m_stream.data();
+    }
+
+    /// Gets the size of the underlying buffer in bytes.
+    ///
+    /// @return the size of the buffer
+    uint64_t size() const
+    {
+        return m_stream.size();
+    }
+
+    /// Returns the error code
+    /// @return the error code
+    std::error_code error() const
+    {
+        return m_error;
+    }
+
+private:
+
+    endian::stream_writer<Endianness> m_stream;
+    std::error_code& m_error;
+};
+}
@@ -0,0 +1,184 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+
+#include "layout.hpp"
+#include "view.hpp"
+
+namespace bnb
+{
+/// A type-length-value entry found by tlv_reader
+struct tlv_entry
+{
+    /// The type, or tag, of the entry
+    uint64_t type = 0;
+
+    /// The value of the entry, which is not decoded or copied
+    bnb::view value;
+};
+
+/// Reads a sequence of type-length-value entries, e.g. options or extension
+/// blocks, of a type field of TypeBytes bytes followed by a length field of
+/// LengthBytes bytes and that number of value bytes.
+///
+/// The entries are read lazily from the reader, one at a time, and their
+/// values are returned as views into the buffer, so only the type and
+/// length fields are decoded:
+///
+///     bnb::tlv_reader<1, 1, decltype(reader)> options(reader);
+///     for (const bnb::tlv_entry& option : options)
+///     {
+///         ...
+///     }
+///
+/// The sequence ends at the end of the reader. A truncated type or length
+/// field, or a length exceeding the remaining data, sets the error code of
+/// the reader to bnb::error::truncated, which also ends the sequence.
+///
+/// @tparam Reader The type of the reader, e.g. a stream_reader, whose
+///         endianness is used for the type and length fields
+template<uint8_t TypeBytes, uint8_t LengthBytes, class Reader>
+class tlv_reader
+{
+public:
+
+    /// The layout of the type and length fields, read with a single bounds
+    /// check
+    using header_layout = layout<field<TypeBytes>, field<LengthBytes>>;
+
+    /// An input iterator over the remaining entries of a tlv_reader
+    class iterator
+    {
+    public:
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = tlv_entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const tlv_entry*;
+        using reference = const tlv_entry&;
+
+    public:
+
+        /// Constructs the end iterator
+        iterator() = default;
+
+        /// Constructs an iterator at the next entry of a reader
+        /// @param reader The reader of the entries
+        explicit iterator(tlv_reader* reader) :
+            m_reader(reader)
+        {
+            ++(*this);
+        }
+
+        /// @return The current entry
+        reference operator*() const
+        {
+            return m_entry;
+        }
+
+        /// @return The current entry
+        pointer operator->() const
+        {
+            return &m_entry;
+        }
+
+        /// Moves to the next entry, or to the end
+        iterator& operator++()
+        {
+            if (!m_reader->next(m_entry))
+                m_reader = nullptr;
+
+            return *this;
+        }
+
+        /// @return True if both iterators are at the end, or neither is
+        bool operator==(const iterator& other) const
+        {
+            return m_reader == other.m_reader;
+        }
+
+        /// @return True unless both iterators are at the end, or neither is
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+
+        tlv_reader* m_reader = nullptr;
+        tlv_entry m_entry;
+    };
+
+public:
+
+    /// Constructs a TLV reader
+    /// @param reader The reader positioned at the first entry. It must
+    ///        outlive the TLV reader.
+    explicit tlv_reader(Reader& reader) :
+        m_reader(reader)
+    { }
+
+    /// Reads the next entry and moves the read position past it.
+    ///
+    /// @param entry The destination of the entry
+    /// @return True if an entry was read, false at the end of the entries or
+    ///         if the error code has been set
+    bool next(tlv_entry& entry)
+    {
+        if (m_reader.error() || m_reader.remaining_size() == 0)
+            return false;
+
+        uint64_t type = 0;
+        uint64_t length = 0;
+        m_reader.template read_layout<header_layout>(std::tie(type, length));
+        auto value = m_reader.read_view(length);
+        if (m_reader.error())
+            return false;
+
+        entry.type = type;
+        entry.value = value;
+        return true;
+    }
+
+    /// Finds the next entry of a given type and moves the read position past
+    /// it. The values of the entries before it are skipped.
+    ///
+    /// @param type The type of the entry
+    /// @param entry The destination of the entry
+    /// @return True if the entry was found, false if the end of the entries
+    ///         was reached first or the error code has been set
+    bool find(uint64_t type, tlv_entry& entry)
+    {
+        while (next(entry))
+        {
+            if (entry.type == type)
+                return true;
+        }
+        return false;
+    }
+
+    /// @return An iterator at the next entry
+    iterator begin()
+    {
+        return iterator(this);
+    }
+
+    /// @return The end iterator
+    iterator end()
+    {
+        return iterator();
+    }
+
+private:
+
+    Reader& m_reader;
+};
+}
@@ -21,12 +21,14 @@ class empty
 { };
 }
 
-template<class ValueType>
-class validator : public validator_wrapper<detail::empty, ValueType>
+template<class ValueType, class Context = detail::reader_context<>>
+class validator : public validator_wrapper<detail::empty, ValueType, Context>
 {
 public:
-    validator(ValueType value, std::error_code& error) :
-        validator_wrapper<detail::empty, ValueType>(*this, value, error)
+    validator(ValueType value, typename Context::error_type& error,
+              const Context& context = Context()) :
+        validator_wrapper<detail::empty, ValueType, Context>(
+            *this, value, error, context)
     { }
 };
 }
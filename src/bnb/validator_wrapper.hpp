@@ -10,22 +10,48 @@
 #include <cassert>
 #include <functional>
 
+#include "constant_type.hpp"
+#include "error.hpp"
+#include "reader_context.hpp"
+
 namespace bnb
 {
 
-template<class Super, class ValueType>
+/// Validates a value and forwards calls to the wrapped Super object.
+///
+/// The Context is the diagnostics, stats and error state type of the reader
+/// which read the value, see stream_reader.
+template<class Super, class ValueType,
+         class Context = detail::reader_context<>>
 class validator_wrapper : public Super
 {
+private:
+
+    /// The diagnostics and stats state of the value
+    using context_type = Context;
+
+    /// The error state, std::error_code or status
+    using error_type = typename Context::error_type;
+
+    /// The type of compile-time constants of the value type
+    using constant_type = typename detail::constant_type<ValueType>::type;
+
 public:
 
     /// Constructs a validator wrapper.
-    /// @param super A reference to the wrapped object.
+    /// @param super A reference to the wrapped object. The object is copied,
+    ///              so it should be a cheap handle, e.g. a reference
+    ///              forwarding to the object creating the wrapper.
     /// @param value The value to check
     /// @param error The error code to set if the validation failed
-    validator_wrapper(Super& super, ValueType value, std::error_code& error) :
+    /// @param context Where to report a failed validation
+    validator_wrapper(const Super& super, ValueType value,
+                      error_type& error,
+                      const context_type& context = context_type()) :
         Super(super),
         m_value(value),
-        m_error(error)
+        m_error(error),
+        m_context(context)
     { }
 
     /// Checks if the given value is equal to the expected value.
@@ -38,7 +64,8 @@ public:
             return *this;
 
         if (m_value != expected_value)
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            fail(bnb::error::unexpected_value, diagnostic_kind::expect_eq,
+                 expected_value, expected_value);
 
         return *this;
     }
@@ -53,7 +80,8 @@ public:
             return *this;
 
         if (m_value == expected_value)
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            fail(bnb::error::unexpected_value, diagnostic_kind::expect_ne,
+                 expected_value, expected_value);
 
         return *this;
     }
@@ -68,7 +96,8 @@ public:
             return *this;
 
         if (m_value >= expected_value)
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            fail(bnb::error::value_out_of_range, diagnostic_kind::expect_lt,
+                 expected_value, expected_value);
 
         return *this;
     }
@@ -83,7 +112,8 @@ public:
             return *this;
 
         if (m_value > expected_value)
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            fail(bnb::error::value_out_of_range, diagnostic_kind::expect_le,
+                 expected_value, expected_value);
 
         return *this;
     }
@@ -98,7 +128,8 @@ public:
             return *this;
 
         if (m_value <= expected_value)
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            fail(bnb::error::value_out_of_range, diagnostic_kind::expect_gt,
+                 expected_value, expected_value);
 
         return *this;
     }
@@ -113,7 +144,67 @@ public:
             return *this;
 
         if (m_value < expected_value)
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            fail(bnb::error::value_out_of_range, diagnostic_kind::expect_ge,
+                 expected_value, expected_value);
+
+        return *this;
+    }
+
+    /// Checks if the value is equal to a compile-time constant. The checks
+    /// taking compile-time constants are only available for integral and
+    /// enumeration values.
+    /// @returns A reference to this object, so that more expectations
+    ///          or calls to the wrapped object can be made.
+    template<constant_type Expected, class T = ValueType,
+             detail::constant_check<T> = 0>
+    validator_wrapper& expect_eq()
+    {
+        return expect_eq(Expected);
+    }
+
+    /// Checks if the value is not equal to a compile-time constant.
+    /// @returns A reference to this object, so that more expectations
+    ///          or calls to the wrapped object can be made.
+    template<constant_type Expected, class T = ValueType,
+             detail::constant_check<T> = 0>
+    validator_wrapper& expect_ne()
+    {
+        return expect_ne(Expected);
+    }
+
+    /// Checks if the value is within the compile-time range [Min, Max].
+    /// @returns A reference to this object, so that more expectations
+    ///          or calls to the wrapped object can be made.
+    template<constant_type Min, constant_type Max, class T = ValueType,
+             detail::constant_check<T> = 0>
+    validator_wrapper& expect_in_range()
+    {
+        static_assert(Min <= Max, "Min must not be greater than Max");
+
+        if (m_error)
+            return *this;
+
+        if (!in_range(m_value, Min, Max))
+            fail(bnb::error::value_out_of_range,
+                 diagnostic_kind::expect_in_range, Min, Max);
+
+        return *this;
+    }
+
+    /// Checks if the given value can make the given predicate return true.
+    /// The predicate is called directly, so it can be inlined.
+    /// @param predicate The predicate called with the value
+    /// @returns A reference to this object, so that more expectations
+    ///          or calls to the wrapped object can be made.
+    template<class Predicate>
+    validator_wrapper& expect(Predicate&& predicate)
+    {
+        if (m_error)
+            return *this;
+
+        if (!predicate(m_value))
+            fail(bnb::error::predicate_failed, diagnostic_kind::expect,
+                 ValueType(), ValueType());
 
         return *this;
     }
@@ -128,14 +219,32 @@ public:
             return *this;
 
         if (!expect_func(m_value))
-            m_error = std::make_error_code(std::errc::result_out_of_range);
+            fail(bnb::error::predicate_failed, diagnostic_kind::expect,
+                 ValueType(), ValueType());
 
         return *this;
     }
 
 private:
 
+    /// Sets the error code and reports the failure to the diagnostics sink
+    /// and stats
+    void fail(bnb::error error, diagnostic_kind kind,
+              ValueType expected, ValueType expected_max)
+    {
+        detail::set_error(m_error, error);
+        m_context.report(m_error, kind, m_value, expected, expected_max);
+    }
+
+    /// Range check written so that it doesn't warn when Min is the smallest
+    /// value of an unsigned type.
+    static bool in_range(ValueType value, ValueType min, ValueType max)
+    {
+        return !(value < min) && !(max < value);
+    }
+
     ValueType m_value;
-    std::error_code& m_error;
+    error_type& m_error;
+    context_type m_context;
 };
 }
@@ -0,0 +1,176 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "bit_utility.hpp"
+
+namespace bnb
+{
+/// Unsigned LEB128 variable-length integers, as used by e.g. DWARF, WebAssembly
+/// and protobuf. Each byte holds 7 bits of the value, least significant group
+/// first, with the high bit set on all but the last byte.
+///
+/// Encodings ending in a redundant zero byte, and encodings of more than
+/// 64 bits, are rejected.
+struct leb128
+{
+    /// The maximum size of an encoded 64 bit value
+    enum { max_size = 10 };
+
+    /// Decodes a value.
+    /// @param data The encoded data
+    /// @param size The number of bytes available
+    /// @param value The decoded value, only set if the encoding is valid
+    /// @return The size of the encoding, or 0 if the encoding is invalid. If
+    ///         the returned size is larger than the available size, the
+    ///         data is truncated and at least that many bytes are needed.
+    static uint32_t decode(const uint8_t* data, uint64_t size, uint64_t& value)
+    {
+        if (size >= 8)
+        {
+            // Find the terminating byte in a single 8 byte load
+            uint64_t word = detail::load_little_endian_u64(data);
+            uint64_t stops = ~word & 0x8080808080808080ULL;
+            if (stops != 0)
+            {
+                uint32_t length = detail::count_trailing_zeros(stops) / 8 + 1;
+                if (length > 1 && data[length - 1] == 0)
+                    return 0;
+
+                // Clear the bytes after the terminating byte and compact
+                // the 7 bit groups
+                uint32_t unused_bits = 64 - length * 8;
+                word = (word << unused_bits) >> unused_bits;
+                value =
+                    ((word & 0x000000000000007FULL)) |
+                    ((word & 0x0000000000007F00ULL) >> 1) |
+                    ((word & 0x00000000007F0000ULL) >> 2) |
+                    ((word & 0x000000007F000000ULL) >> 3) |
+                    ((word & 0x0000007F00000000ULL) >> 4) |
+                    ((word & 0x00007F0000000000ULL) >> 5) |
+                    ((word & 0x007F000000000000ULL) >> 6) |
+                    ((word & 0x7F00000000000000ULL) >> 7);
+                return length;
+            }
+        }
+        return decode_slow(data, size, value);
+    }
+
+private:
+
+    /// Decodes a value one byte at a time, used near the end of the data
+    /// and for encodings longer than 8 bytes.
+    static uint32_t decode_slow(
+        const uint8_t* data, uint64_t size, uint64_t& value)
+    {
+        uint64_t result = 0;
+        for (uint32_t i = 0; i < (uint32_t)max_size; ++i)
+        {
+            if (i >= size)
+                return i + 1;
+
+            uint8_t byte = data[i];
+            // The 10th byte may only hold the 64th bit of the value
+            if (i == (uint32_t)max_size - 1 && byte > 1)
+                return 0;
+
+            result |= (uint64_t)(byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0)
+            {
+                if (i > 0 && byte == 0)
+                    return 0;
+
+                value = result;
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+};
+
+/// Protobuf varints are unsigned LEB128 encoded
+using protobuf_varint = leb128;
+
+/// QUIC variable-length integers (RFC 9000 section 16). The two most
+/// significant bits of the first byte give the size of the encoding as 1, 2,
+/// 4 or 8 bytes, the remaining bits hold the value in big endian byte order.
+///
+/// Encodings which are longer than needed for the value are accepted, as
+/// RFC 9000 allows them, e.g. a two byte Length field holding a value below
+/// 64. See quic_varint_strict for rejecting them.
+struct quic_varint
+{
+    /// The maximum size of an encoded value
+    enum { max_size = 8 };
+
+    /// Decodes a value.
+    /// @param data The encoded data
+    /// @param size The number of bytes available
+    /// @param value The decoded value, only set if the encoding is valid
+    /// @return The size of the encoding, or 0 if the encoding is invalid. If
+    ///         the returned size is larger than the available size, the
+    ///         data is truncated and at least that many bytes are needed.
+    static uint32_t decode(const uint8_t* data, uint64_t size, uint64_t& value)
+    {
+        if (size == 0)
+            return 1;
+
+        uint32_t prefix = data[0] >> 6;
+        uint32_t length = 1U << prefix;
+        if (length > size)
+            return length;
+
+        uint64_t result;
+        if (size >= 8)
+        {
+            // A single 8 byte load, shifted down to the size of the encoding
+            result = detail::load_big_endian_u64(data) >> (64 - length * 8);
+        }
+        else
+        {
+            result = 0;
+            for (uint32_t i = 0; i < length; ++i)
+                result = (result << 8) | data[i];
+        }
+        result &= ~(uint64_t)0 >> (66 - length * 8);
+
+        value = result;
+        return length;
+    }
+};
+
+/// QUIC variable-length integers, see quic_varint, where encodings which
+/// are longer than needed for the value are rejected. This is for fields
+/// which must use the minimal encoding, e.g. the frame types of RFC 9000
+/// section 12.4.
+struct quic_varint_strict
+{
+    /// The maximum size of an encoded value
+    enum { max_size = quic_varint::max_size };
+
+    /// Decodes a value, see quic_varint::decode().
+    /// @return The size of the encoding, or 0 if the encoding is invalid or
+    ///         longer than needed
+    static uint32_t decode(const uint8_t* data, uint64_t size, uint64_t& value)
+    {
+        uint64_t result = 0;
+        uint32_t length = quic_varint::decode(data, size, result);
+        if (length > size)
+            return length;
+
+        // The smallest value which needs an encoding of each size
+        static const uint64_t minimum[] = { 0, 64, 16384, 1073741824 };
+        if (result < minimum[data[0] >> 6])
+            return 0;
+
+        value = result;
+        return length;
+    }
+};
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+
+#if defined(__has_include)
+#if __has_include(<span>) && __cplusplus >= 202002L
+#include <span>
+#endif
+#endif
+
+namespace bnb
+{
+/// A non-owning view of bytes in the buffer of a reader, see
+/// stream_reader::read_view(). The view is empty if the read failed.
+class view
+{
+public:
+
+    /// Constructs an empty view
+    view() = default;
+
+    /// Constructs a view
+    /// @param data The pointer to the data
+    /// @param size The size of the data in bytes
+    view(const uint8_t* data, uint64_t size) :
+        m_data(data),
+        m_size(size)
+    { }
+
+    /// @return The pointer to the data. It is nullptr for a default
+    ///         constructed view, e.g. from a failed read, while a view of
+    ///         zero bytes read from a buffer points into the buffer. Use
+    ///         empty() to check for data.
+    const uint8_t* data() const
+    {
+        return m_data;
+    }
+
+    /// @return The size of the data in bytes
+    uint64_t size() const
+    {
+        return m_size;
+    }
+
+    /// @return true if the view has no data
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// @return The byte at a given index
+    uint8_t operator[](uint64_t index) const
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+    /// @return An iterator to the first byte
+    const uint8_t* begin() const
+    {
+        return m_data;
+    }
+
+    /// @return An iterator past the last byte
+    const uint8_t* end() const
+    {
+        return m_data + m_size;
+    }
+
+#if defined(__cpp_lib_span)
+    /// @return The view as a std::span
+    operator std::span<const uint8_t>() const
+    {
+        return std::span<const uint8_t>(m_data, m_size);
+    }
+#endif
+
+private:
+
+    const uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+};
+}
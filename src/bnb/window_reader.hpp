@@ -0,0 +1,206 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <system_error>
+#include <cassert>
+#include <endian/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include "bit_reader.hpp"
+#include "error.hpp"
+#include "validator.hpp"
+
+namespace bnb
+{
+/// A reader over a window of bytes which has already been bounds checked,
+/// see stream_reader::require(). The fixed size reads of the window only
+/// check the sticky error code, the bounds are only verified with asserts.
+/// This allows reading a fixed layout header with a single bounds check.
+/// The runtime offsets and sizes of peek_bytes() and skip() are checked.
+///
+/// The Error is the type of the error state, std::error_code or status.
+template<class Endianness, class Error = std::error_code>
+class window_reader
+{
+private:
+
+    /// The validators of a window don't report diagnostics or count stats
+    using context_type =
+        detail::reader_context<no_diagnostics, no_stats, Error>;
+
+public:
+
+    /// Constructs a window reader over a bounds checked buffer.
+    ///
+    /// @param data The pointer to the data.
+    /// @param size The size of the window
+    /// @param error A reference to the error code to set if an error happened
+    window_reader(const uint8_t* data, uint64_t size, Error& error) :
+        m_stream(data, size),
+        m_error(error)
+    { }
+
+    /// Reads from the window and moves the read position.
+    ///
+    /// @param value reference to the value to be read.
+    template<uint8_t Bytes, class ValueType>
+    validator<ValueType, context_type> read_bytes(ValueType& value)
+    {
+        if (m_error)
+            return { value, m_error };
+
+        assert(Bytes <= m_stream.remaining_size());
+        m_stream.template read_bytes<Bytes, ValueType>(value);
+        return { value, m_error };
+    }
+
+    /// Reads from the window and moves the read position.
+    template<uint8_t Bytes>
+    validator<uint64_t, context_type> read_bytes()
+    {
+        uint64_t value = 0;
+        return read_bytes<Bytes, uint64_t>(value);
+    }
+
+    /// Peeks in the window without moving the read position.
+    ///
+    /// @param value reference to the value to be read.
+    /// @param offset number of bytes to offset the peeking with. If the
+    ///        peek exceeds the window the error code is set to
+    ///        bnb::error::truncated.
+    template<uint8_t Bytes, class ValueType>
+    validator<ValueType, context_type> peek_bytes(
+        ValueType& value, uint64_t offset=0) const
+    {
+        if (m_error)
+            return { value, m_error };
+
+        if (offset > m_stream.remaining_size() ||
+            Bytes > m_stream.remaining_size() - offset)
+        {
+            detail::set_error(m_error, bnb::error::truncated);
+            return { value, m_error };
+        }
+        m_stream.template peek_bytes<Bytes, ValueType>(value, offset);
+        return { value, m_error };
+    }
+
+    /// Peeks in the window without moving the read position.
+    /// @param offset number of bytes to offset the peeking with
+    template<uint8_t Bytes>
+    validator<uint64_t, context_type> peek_bytes(uint64_t offset=0) const
+    {
+        uint64_t value = 0;
+        return peek_bytes<Bytes, uint64_t>(value, offset);
+    }
+
+    /// Returns a Bit Reader covering a given number of bytes and
+    /// moves the read position.
+    /// @return A bit reader covering the number of bytes in the Type template.
+    template<class Type, class BitNumbering, uint32_t... Sizes>
+    basic_bit_reader<context_type, Type, BitNumbering, Sizes...> read_bits()
+    {
+        using reader_type =
+            basic_bit_reader<context_type, Type, BitNumbering, Sizes...>;
+        using value_type = typename Type::type;
+        value_type value = 0;
+
+        if (m_error)
+        {
+            return reader_type(value, m_error);
+        }
+
+        assert(Type::size <= m_stream.remaining_size());
+        m_stream.template read_bytes<Type::size, value_type>(value);
+        return reader_type(value, m_error);
+    }
+
+    /// Skips over a given number of bytes in the window
+    ///
+    /// @param bytes_to_skip the bytes to skip. If they exceed the window the
+    ///        error code is set to bnb::error::invalid_seek.
+    /// @return A window reader covering the skipped bytes, or an empty
+    ///         window if the skip failed.
+    window_reader<Endianness, Error> skip(uint64_t bytes_to_skip)
+    {
+        if (m_error)
+        {
+            return window_reader<Endianness, Error>(
+                m_stream.data(), 0, m_error);
+        }
+
+        if (bytes_to_skip > m_stream.remaining_size())
+        {
+            detail::set_error(m_error, bnb::error::invalid_seek);
+            return window_reader<Endianness, Error>(
+                m_stream.data(), 0, m_error);
+        }
+
+        auto remaining_data = m_stream.remaining_data();
+        m_stream.skip(bytes_to_skip);
+        return window_reader<Endianness, Error>(
+            remaining_data, bytes_to_skip, m_error);
+    }
+
+    /// A pointer to the window's data at the current position.
+    ///
+    /// @return pointer to the window's data at the current position.
+    const uint8_t* remaining_data() const
+    {
+        assert(!m_error);
+        return m_stream.remaining_data();
+    }
+
+    /// Gets the current read position in the window
+    ///
+    /// @return the current position.
+    uint64_t position() const
+    {
+        assert(!m_error);
+        return m_stream.position();
+    }
+
+    /// The remaining number of bytes in the window
+    ///
+    /// @return the remaining number of bytes.
+    uint64_t remaining_size() const
+    {
+        assert(!m_error);
+        return m_stream.remaining_size();
+    }
+
+    /// A pointer to the window's data.
+    ///
+    /// @return pointer to the window's data.
+    const uint8_t* data() const
+    {
+        return m_stream.data();
+    }
+
+    /// Gets the size of the window in bytes.
+    ///
+    /// @return the size of the window
+    uint64_t size() const
+    {
+        return m_stream.size();
+    }
+
+    /// Returns the error code
+    /// @return the error code
+    std::error_code error() const
+    {
+        return detail::to_error_code(m_error);
+    }
+
+private:
+
+    endian::stream_reader<Endianness> m_stream;
+    Error& m_error;
+};
+}
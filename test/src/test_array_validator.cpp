@@ -0,0 +1,38 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/array_validator.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_array_validator, api)
+{
+    std::error_code error;
+    std::vector<uint32_t> values {40, 41, 42};
+    bnb::array_validator<uint32_t> validator(
+        values.data(), values.size(), error);
+
+    validator.expect_lt(43);
+    validator.expect_le(42);
+    validator.expect_gt(39);
+    validator.expect_ge(40);
+    validator.expect([](uint32_t value) { return value % 40 < 3; });
+    ASSERT_TRUE(!error);
+
+    validator.expect_lt(42);
+    ASSERT_FALSE(!error);
+
+    // make sure we don't crash after a failed validation has happened and the
+    // error is still there
+    validator.expect_lt(43);
+    ASSERT_FALSE(!error);
+}
+
+TEST(test_array_validator, empty)
+{
+    std::error_code error;
+    bnb::array_validator<uint32_t> validator(nullptr, 0, error);
+    validator.expect([](uint32_t) { return false; });
+    ASSERT_TRUE(!error);
+}
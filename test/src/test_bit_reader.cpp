@@ -5,6 +5,8 @@
 
 #include <bnb/bit_reader.hpp>
 
+#include <utility>
+
 #include <gtest/gtest.h>
 
 TEST(test_bit_reader, api)
@@ -67,3 +69,62 @@ TEST(test_bit_reader, force_error)
     EXPECT_EQ(0U, field3);
     EXPECT_EQ(0U, field4);
 }
+
+TEST(test_bit_reader, chain_references_reader)
+{
+    using small_reader = bnb::bit_reader<bitter::u8, bitter::msb0, 8>;
+    using large_reader = bnb::bit_reader<bitter::u64, bitter::msb0, 64>;
+
+    // The validators only hold a reference to a bit reader which is an
+    // lvalue, so their size does not depend on the size of the bit reader.
+    using small_validator =
+        decltype(std::declval<small_reader&>().get<0>(
+            std::declval<uint8_t&>()));
+    using large_validator =
+        decltype(std::declval<large_reader&>().get<0>(
+            std::declval<uint8_t&>()));
+
+    EXPECT_EQ(sizeof(small_validator), sizeof(large_validator));
+
+    std::error_code error;
+    bnb::bit_reader<bitter::u16, bitter::lsb0, 4, 4, 8> reader(0x1234, error);
+
+    uint8_t field0 = 0;
+    uint8_t field1 = 0;
+    uint8_t field2 = 0;
+
+    reader.get<0>(field0).expect_eq(4U)
+    .get<1>(field1).expect_eq(3U)
+    .get<2>(field2).expect_eq(0x12U);
+
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(4U, field0);
+    EXPECT_EQ(3U, field1);
+    EXPECT_EQ(0x12U, field2);
+}
+
+TEST(test_bit_reader, stored_validator)
+{
+    std::error_code error;
+    uint8_t field0 = 0;
+    uint8_t field1 = 0;
+    uint8_t field2 = 0;
+
+    // The validator of a temporary bit reader holds a copy of it, so it can
+    // be used after the bit reader is gone
+    auto validator =
+        bnb::bit_reader<bitter::u16, bitter::lsb0, 4, 4, 8>(0x1234, error)
+        .get<0>(field0);
+    validator.get<1>(field1).expect_eq(3U);
+    auto next = validator.get<2>(field2);
+    next.expect_eq(0x12U);
+
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(4U, field0);
+    EXPECT_EQ(3U, field1);
+    EXPECT_EQ(0x12U, field2);
+
+    // The error code is still shared with the reader
+    validator.get<1>(field1).expect_eq(4U);
+    EXPECT_EQ(bnb::error::unexpected_value, error);
+}
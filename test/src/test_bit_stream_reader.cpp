@@ -0,0 +1,387 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/bit_stream_reader.hpp>
+
+#include <cstdint>
+#include <random>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Reads a field one bit at a time
+uint64_t reference_msb0(const std::vector<uint8_t>& data, uint64_t position,
+                        uint32_t bits)
+{
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < bits; ++i, ++position)
+    {
+        uint64_t bit = (data[position / 8] >> (7 - position % 8)) & 1;
+        value = (value << 1) | bit;
+    }
+    return value;
+}
+
+uint64_t reference_lsb0(const std::vector<uint8_t>& data, uint64_t position,
+                        uint32_t bits)
+{
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < bits; ++i, ++position)
+    {
+        uint64_t bit = (data[position / 8] >> (position % 8)) & 1;
+        value |= bit << i;
+    }
+    return value;
+}
+
+template<class BitNumbering, class Reference>
+void test_random_fields(Reference reference)
+{
+    std::mt19937 random(1);
+    std::vector<uint8_t> data(301);
+    for (auto& byte : data)
+        byte = (uint8_t)random();
+
+    std::error_code error;
+    bnb::bit_stream_reader<BitNumbering> reader(
+        data.data(), data.size(), error);
+
+    uint64_t position = 0;
+    while (true)
+    {
+        uint32_t bits = random() % 64 + 1;
+        if (position + bits > data.size() * 8)
+            break;
+
+        EXPECT_EQ(position, reader.bit_position());
+        uint64_t value = 0;
+        if (bits <= 56)
+        {
+            reader.peek_bits(value, bits);
+            EXPECT_EQ(reference(data, position, bits), value);
+        }
+        reader.read_bits(value, bits);
+        EXPECT_EQ(reference(data, position, bits), value);
+        position += bits;
+    }
+
+    EXPECT_FALSE((bool)error);
+    reader.template read_bits<64>();
+    EXPECT_EQ(bnb::error::truncated, error);
+}
+}
+
+TEST(test_bit_stream_reader, random_fields_msb0)
+{
+    test_random_fields<bitter::msb0>(reference_msb0);
+}
+
+TEST(test_bit_stream_reader, random_fields_lsb0)
+{
+    test_random_fields<bitter::lsb0>(reference_lsb0);
+}
+
+TEST(test_bit_stream_reader, read_bits)
+{
+    std::vector<uint8_t> data {0xA5, 0xF0, 0x0F};
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::msb0> reader(
+        data.data(), data.size(), error);
+
+    uint8_t flag = 0;
+    uint16_t field = 0;
+    reader.read_bits<1>(flag).expect_eq(1);
+    reader.read_bits<3>().expect_eq(2);
+    EXPECT_FALSE(reader.is_aligned());
+    reader.read_bits<12>(field).expect_eq(0x5F0);
+    EXPECT_TRUE(reader.is_aligned());
+    EXPECT_EQ(2U, reader.position());
+    reader.read_bits<8>().expect_eq(0x0F);
+    EXPECT_EQ(0U, reader.remaining_bits());
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(1U, flag);
+    EXPECT_EQ(0x5F0U, field);
+
+    reader.read_bits<1>();
+    EXPECT_EQ(bnb::error::truncated, error);
+}
+
+TEST(test_bit_stream_reader, invalid_width)
+{
+    std::vector<uint8_t> data(16, 0xFF);
+    uint8_t byte = 0;
+    uint64_t value = 0;
+
+    for (uint32_t bits : {0U, 9U})
+    {
+        std::error_code error;
+        bnb::bit_stream_reader<bitter::msb0> reader(
+            data.data(), data.size(), error);
+        reader.read_bits(byte, bits);
+        EXPECT_EQ(bnb::error::invalid_size, error);
+        EXPECT_EQ(0U, byte);
+    }
+
+    for (uint32_t bits : {0U, 57U})
+    {
+        std::error_code error;
+        bnb::bit_stream_reader<bitter::lsb0> reader(
+            data.data(), data.size(), error);
+        reader.peek_bits(value, bits);
+        EXPECT_EQ(bnb::error::invalid_size, error);
+        EXPECT_EQ(std::errc::invalid_argument, error);
+    }
+
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::msb0> reader(
+        data.data(), data.size(), error);
+    reader.read_bits(value, 64);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(UINT64_MAX, value);
+    reader.read_truncated_binary(value, 0);
+    EXPECT_EQ(bnb::error::invalid_size, error);
+}
+
+TEST(test_bit_stream_reader, skip_and_align)
+{
+    std::vector<uint8_t> data(32);
+    for (uint32_t i = 0; i < data.size(); ++i)
+        data[i] = (uint8_t)i;
+
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::lsb0> reader(
+        data.data(), data.size(), error);
+
+    reader.read_bits<3>();
+    reader.align();
+    EXPECT_EQ(8U, reader.bit_position());
+    reader.align();
+    EXPECT_EQ(8U, reader.bit_position());
+    reader.read_bits<8>().expect_eq(1);
+
+    // Skip within and beyond the buffer
+    reader.skip_bits(4);
+    reader.read_bits<4>().expect_eq(0);
+    reader.skip_bits(8 * 20 + 5);
+    EXPECT_EQ(8U * 23 + 5, reader.bit_position());
+    reader.read_bits<3>().expect_eq(23 >> 5);
+    reader.read_bits<8>().expect_eq(24);
+    EXPECT_FALSE((bool)error);
+
+    reader.skip_bits(reader.remaining_bits() + 1);
+    EXPECT_EQ(bnb::error::invalid_seek, error);
+}
+
+namespace
+{
+// Writes codes one bit at a time, most significant bit first
+struct bit_writer_msb0
+{
+    void write(uint64_t value, uint32_t bits)
+    {
+        for (uint32_t i = bits; i > 0; --i)
+        {
+            if (m_bits % 8 == 0)
+                m_data.push_back(0);
+            uint64_t bit = (value >> (i - 1)) & 1;
+            m_data.back() |= (uint8_t)(bit << (7 - m_bits % 8));
+            ++m_bits;
+        }
+    }
+
+    void write_exp_golomb(uint64_t value)
+    {
+        uint32_t bits = 0;
+        while (((value + 1) >> bits) > 1)
+            ++bits;
+        write(0, bits);
+        write(value + 1, bits + 1);
+    }
+
+    std::vector<uint8_t> m_data;
+    uint64_t m_bits = 0;
+};
+}
+
+TEST(test_bit_stream_reader, unary)
+{
+    // 0001 1110 1111 1111 1111 1111 ...
+    std::vector<uint8_t> data {0x1E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                               0xFF, 0xFF, 0xFF, 0xFE};
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::msb0> reader(
+        data.data(), data.size(), error);
+
+    reader.read_unary<1>().expect_eq(3);
+    reader.read_unary<0>().expect_eq(3);
+    // The run of 9 * 8 + 7 ones crosses the refills of the buffer
+    reader.read_unary<0>().expect_eq(79);
+    EXPECT_EQ(0U, reader.remaining_bits());
+    EXPECT_FALSE((bool)error);
+
+    reader.read_unary<1>();
+    EXPECT_EQ(bnb::error::truncated, error);
+}
+
+TEST(test_bit_stream_reader, unary_lsb0)
+{
+    std::vector<uint8_t> data {0x08, 0x00, 0x01};
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::lsb0> reader(
+        data.data(), data.size(), error);
+
+    uint8_t value = 0;
+    reader.read_unary<1>(value).expect_eq(3);
+    reader.read_unary<1>().expect_eq(12);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(3U, value);
+}
+
+TEST(test_bit_stream_reader, exp_golomb)
+{
+    std::vector<uint64_t> values {0, 1, 2, 3, 4, 7, 8, 255, 256, 65535,
+                                  (uint64_t(1) << 40) + 3, UINT64_MAX - 1};
+    bit_writer_msb0 writer;
+    for (uint64_t value : values)
+        writer.write_exp_golomb(value);
+
+    // se(v) of 2 is -1 and of 5 is 3
+    writer.write_exp_golomb(2);
+    writer.write_exp_golomb(5);
+
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::msb0> reader(
+        writer.m_data.data(), writer.m_data.size(), error);
+
+    for (uint64_t value : values)
+        reader.read_exp_golomb().expect_eq(value);
+
+    int32_t signed_value = 0;
+    reader.read_signed_exp_golomb(signed_value).expect_eq(-1);
+    reader.read_signed_exp_golomb().expect_eq(3);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(writer.m_bits, reader.bit_position());
+}
+
+TEST(test_bit_stream_reader, exp_golomb_errors)
+{
+    {
+        // A prefix of 64 zeros
+        std::vector<uint8_t> data(9, 0);
+        std::error_code error;
+        bnb::bit_stream_reader<bitter::msb0> reader(
+            data.data(), data.size(), error);
+        reader.read_exp_golomb();
+        EXPECT_EQ(bnb::error::invalid_varint, error);
+    }
+    {
+        bit_writer_msb0 writer;
+        writer.write_exp_golomb(256);
+        std::error_code error;
+        bnb::bit_stream_reader<bitter::msb0> reader(
+            writer.m_data.data(), writer.m_data.size(), error);
+        uint8_t value = 0;
+        reader.read_exp_golomb(value);
+        EXPECT_EQ(bnb::error::value_too_large, error);
+    }
+    {
+        // The suffix is cut off
+        std::vector<uint8_t> data {0x00, 0x01};
+        std::error_code error;
+        bnb::bit_stream_reader<bitter::msb0> reader(
+            data.data(), data.size(), error);
+        reader.read_exp_golomb();
+        EXPECT_EQ(bnb::error::truncated, error);
+    }
+}
+
+TEST(test_bit_stream_reader, truncated_binary)
+{
+    // With 5 symbols 0 to 2 are coded in 2 bits and 3 and 4 in 3 bits
+    bit_writer_msb0 writer;
+    writer.write(0, 2);
+    writer.write(2, 2);
+    writer.write(6, 3);
+    writer.write(7, 3);
+    // With 1 symbol no bits are used, with 8 symbols 3 bits
+    writer.write(5, 3);
+
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::msb0> reader(
+        writer.m_data.data(), writer.m_data.size(), error);
+
+    reader.read_truncated_binary(5).expect_eq(0);
+    reader.read_truncated_binary(5).expect_eq(2);
+    reader.read_truncated_binary(5).expect_eq(3);
+    reader.read_truncated_binary(5).expect_eq(4);
+    reader.read_truncated_binary(1).expect_eq(0);
+    reader.read_truncated_binary(8).expect_eq(5);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(writer.m_bits, reader.bit_position());
+}
+
+TEST(test_bit_stream_reader, truncated_binary_value_too_large)
+{
+    // With 300 symbols 0 to 211 are coded in 8 bits and the rest in 9 bits
+    bit_writer_msb0 writer;
+    writer.write(211, 8);
+    writer.write(255 + 212 + 1, 9);
+
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::msb0> reader(
+        writer.m_data.data(), writer.m_data.size(), error);
+
+    uint8_t value = 0;
+    reader.read_truncated_binary(value, 300).expect_eq(211);
+    EXPECT_FALSE((bool)error);
+
+    // 256 doesn't fit in the uint8_t
+    reader.read_truncated_binary(value, 300);
+    EXPECT_EQ(bnb::error::value_too_large, error);
+    EXPECT_EQ(211U, value);
+}
+
+TEST(test_bit_stream_reader, emulation_prevention)
+{
+    // The 0x03 after two zero bytes is removed, also across the refills of
+    // the buffer, but not after a single zero byte
+    std::vector<uint8_t> data {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                               0x00, 0x00, 0x03, 0x01, 0x00, 0x03, 0x00,
+                               0x00, 0x03, 0x00, 0x00, 0x03, 0x03, 0xAB};
+    std::vector<uint8_t> payload {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                  0x00, 0x00, 0x01, 0x00, 0x03, 0x00, 0x00,
+                                  0x00, 0x00, 0x03, 0xAB};
+
+    for (uint32_t bits = 1; bits <= 64; ++bits)
+    {
+        std::error_code error;
+        bnb::bit_stream_reader<bitter::msb0, bnb::emulation_prevention>
+        reader(data.data(), data.size(), error);
+
+        uint64_t position = 0;
+        while (position + bits <= payload.size() * 8)
+        {
+            uint64_t value = 0;
+            reader.read_bits(value, bits);
+            EXPECT_EQ(reference_msb0(payload, position, bits), value);
+            position += bits;
+            EXPECT_EQ(position, reader.bit_position());
+        }
+        EXPECT_FALSE((bool)error);
+    }
+
+    std::error_code error;
+    bnb::bit_stream_reader<bitter::msb0, bnb::emulation_prevention> reader(
+        bnb::view(data.data(), data.size()), error);
+    reader.skip_bits(8 * 10 + 1);
+    reader.read_bits<15>().expect_eq(0x03);
+    reader.skip_bits(8 * 5);
+    reader.read_bits<8>().expect_eq(0xAB);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(payload.size() * 8, reader.bit_position());
+}
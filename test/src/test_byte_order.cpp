@@ -0,0 +1,123 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/byte_order.hpp>
+
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct pcap_header
+{
+    uint16_t version_major;
+    uint16_t version_minor;
+    uint32_t snaplen;
+    uint32_t network;
+};
+
+const uint64_t pcap_magic = 0xA1B2C3D4;
+
+std::vector<uint8_t> big_endian_pcap {
+    0xA1, 0xB2, 0xC3, 0xD4, 0x00, 0x02, 0x00, 0x04,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x01};
+
+std::vector<uint8_t> little_endian_pcap {
+    0xD4, 0xC3, 0xB2, 0xA1, 0x02, 0x00, 0x04, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00};
+
+template<class Error>
+pcap_header parse_pcap(const std::vector<uint8_t>& data, Error& error)
+{
+    return bnb::parse_with_magic<4>(pcap_magic, data.data(), data.size(),
+                                    error, [](auto& reader)
+    {
+        pcap_header header = {};
+        EXPECT_EQ(4U, reader.position());
+        reader.template read_bytes<2>(header.version_major).expect_eq(2);
+        reader.template read_bytes<2>(header.version_minor);
+        reader.skip(8);
+        reader.template read_bytes<4>(header.snaplen);
+        reader.template read_bytes<4>(header.network);
+        return header;
+    });
+}
+}
+
+TEST(test_byte_order, parse_with_magic)
+{
+    for (const auto& data : {big_endian_pcap, little_endian_pcap})
+    {
+        std::error_code error;
+        pcap_header header = parse_pcap(data, error);
+        EXPECT_FALSE((bool)error);
+        EXPECT_EQ(2U, header.version_major);
+        EXPECT_EQ(4U, header.version_minor);
+        EXPECT_EQ(0xFFFFU, header.snaplen);
+        EXPECT_EQ(1U, header.network);
+    }
+
+    bnb::status status;
+    pcap_header header = parse_pcap(little_endian_pcap, status);
+    EXPECT_FALSE((bool)status);
+    EXPECT_EQ(0xFFFFU, header.snaplen);
+}
+
+TEST(test_byte_order, parse_with_magic_errors)
+{
+    {
+        auto data = big_endian_pcap;
+        data[0] = 0xA2;
+        std::error_code error;
+        pcap_header header = parse_pcap(data, error);
+        EXPECT_EQ(bnb::error::unexpected_value, error);
+        EXPECT_EQ(0U, header.snaplen);
+    }
+    {
+        std::vector<uint8_t> data(little_endian_pcap.begin(),
+                                  little_endian_pcap.begin() + 3);
+        std::error_code error;
+        parse_pcap(data, error);
+        EXPECT_EQ(bnb::error::truncated, error);
+    }
+    {
+        std::vector<uint8_t> data(little_endian_pcap.begin(),
+                                  little_endian_pcap.begin() + 20);
+        bnb::status status;
+        parse_pcap(data, status);
+        EXPECT_EQ(bnb::error::truncated, status.value());
+    }
+}
+
+TEST(test_byte_order, parse_with_byte_order)
+{
+    // A TIFF header, where the byte order mark is "II" or "MM"
+    std::vector<uint8_t> data {'M', 'M', 0x00, 0x2A, 0x00, 0x00, 0x00, 0x08};
+
+    std::error_code error;
+    auto order = data[0] == 'I' ?
+        bnb::byte_order::little_endian : bnb::byte_order::big_endian;
+
+    uint32_t offset = 0;
+    bnb::parse_with_byte_order(order, data.data(), data.size(), error,
+                               [&offset](auto& reader)
+    {
+        reader.skip(2);
+        reader.template read_bytes<2>().expect_eq(42);
+        reader.template read_bytes<4>(offset);
+    });
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(8U, offset);
+
+    bnb::byte_order detected = bnb::byte_order::big_endian;
+    EXPECT_TRUE(bnb::detect_byte_order<2>(
+        0x2A00, data.data() + 2, 2, error, detected));
+    EXPECT_EQ(bnb::byte_order::little_endian, detected);
+}
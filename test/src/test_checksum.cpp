@@ -0,0 +1,252 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/checksum.hpp>
+#include <bnb/checksum_reader.hpp>
+#include <bnb/diagnostics.hpp>
+#include <bnb/status.hpp>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Computes a reflected CRC-32 one bit at a time
+uint32_t reference_crc(uint32_t polynomial, const std::vector<uint8_t>& data)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint8_t byte : data)
+    {
+        crc ^= byte;
+        for (uint32_t bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+    }
+    return ~crc;
+}
+
+// Adds the data to a checksum in random blocks
+template<class Checksum>
+typename Checksum::value_type checksum_in_blocks(
+    const std::vector<uint8_t>& data, std::mt19937& random)
+{
+    Checksum checksum;
+    uint64_t position = 0;
+    while (position < data.size())
+    {
+        uint64_t size = random() % 300;
+        size = std::min<uint64_t>(size, data.size() - position);
+        checksum.update(data.data() + position, size);
+        position += size;
+    }
+    return checksum.value();
+}
+
+std::vector<uint8_t> check_string()
+{
+    const char* text = "123456789";
+    return std::vector<uint8_t>(text, text + std::strlen(text));
+}
+}
+
+TEST(test_checksum, check_values)
+{
+    auto data = check_string();
+
+    bnb::crc32 crc32;
+    crc32.update(data.data(), data.size());
+    EXPECT_EQ(0xCBF43926U, crc32.value());
+
+    bnb::crc32c crc32c;
+    crc32c.update(data.data(), data.size());
+    EXPECT_EQ(0xE3069283U, crc32c.value());
+
+    crc32c.clear();
+    EXPECT_EQ(0U, crc32c.value());
+
+    // The example of RFC 1071
+    std::vector<uint8_t> words {0x00, 0x01, 0xF2, 0x03, 0xF4, 0xF5, 0xF6, 0xF7};
+    bnb::internet_checksum internet;
+    internet.update(words.data(), words.size());
+    EXPECT_EQ(0x220DU, internet.value());
+}
+
+TEST(test_checksum, random_blocks)
+{
+    std::mt19937 random(5);
+
+    // Cover the folding of the CRC instructions and the table tails
+    for (uint64_t size : {0, 1, 7, 15, 16, 63, 64, 65, 80, 127, 128, 1000,
+                          4099})
+    {
+        std::vector<uint8_t> data(size);
+        for (auto& byte : data)
+            byte = (uint8_t)random();
+
+        EXPECT_EQ(reference_crc(0xEDB88320, data),
+                  checksum_in_blocks<bnb::crc32>(data, random));
+        EXPECT_EQ(reference_crc(0x82F63B78, data),
+                  checksum_in_blocks<bnb::crc32c>(data, random));
+
+        bnb::internet_checksum whole;
+        whole.update(data.data(), data.size());
+
+        uint32_t sum = 0;
+        for (uint64_t i = 0; i < size; ++i)
+            sum += i % 2 == 0 ? data[i] << 8 : data[i];
+        while (sum > 0xFFFF)
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        EXPECT_EQ((uint16_t)~sum, whole.value());
+        EXPECT_EQ(whole.value(),
+                  checksum_in_blocks<bnb::internet_checksum>(data, random));
+    }
+}
+
+TEST(test_checksum, checksum_reader)
+{
+    // Two frames of a length, a payload and a big endian CRC-32
+    std::vector<uint8_t> data;
+    for (auto payload : {check_string(), std::vector<uint8_t>(100, 0xAB)})
+    {
+        std::vector<uint8_t> frame {0x00, (uint8_t)payload.size()};
+        frame.insert(frame.end(), payload.begin(), payload.end());
+
+        bnb::crc32 crc;
+        crc.update(frame.data(), frame.size());
+        for (uint32_t shift : {24, 16, 8, 0})
+            frame.push_back((uint8_t)(crc.value() >> shift));
+        data.insert(data.end(), frame.begin(), frame.end());
+    }
+
+    std::error_code error;
+    bnb::checksum_reader<bnb::crc32, endian::big_endian> reader(
+        data.data(), data.size(), error);
+
+    uint16_t length = 0;
+    reader.read_bytes<2>(length);
+    reader.peek_bytes<1>().expect_eq('1');
+    reader.read_view(length);
+    EXPECT_EQ(0xCBF43926U, reference_crc(0xEDB88320, check_string()));
+    reader.expect_checksum<4>();
+    EXPECT_FALSE((bool)error);
+
+    reader.read_bytes<2>(length);
+    reader.skip(length);
+    reader.expect_checksum<4>();
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(0U, reader.remaining_size());
+
+    // Corrupt a byte of the second payload
+    data[30] ^= 1;
+    bnb::checksum_reader<bnb::crc32, endian::big_endian> corrupted(
+        data.data(), data.size(), error);
+    corrupted.read_bytes<2>(length);
+    corrupted.skip(length);
+    corrupted.expect_checksum<4>();
+    EXPECT_FALSE((bool)error);
+    corrupted.read_bytes<2>(length);
+    corrupted.skip(length);
+    corrupted.expect_checksum<4>();
+    EXPECT_EQ(bnb::error::unexpected_value, error);
+}
+
+TEST(test_checksum, checksum_reader_restart)
+{
+    // An IPv4 like header, where the checksum covers the header after a
+    // prefix
+    std::vector<uint8_t> data {0xFF, 0x45, 0x00, 0x00, 0x1C, 0x00, 0x00};
+    bnb::internet_checksum internet;
+    internet.update(data.data() + 1, data.size() - 1);
+    data.push_back((uint8_t)(internet.value() >> 8));
+    data.push_back((uint8_t)internet.value());
+
+    std::error_code error;
+    bnb::checksum_reader<bnb::internet_checksum, endian::big_endian> reader(
+        data.data(), data.size(), error);
+    reader.read_bytes<1>();
+    reader.restart();
+    reader.read_bytes<4>();
+    reader.read_bytes<2>();
+    EXPECT_EQ(internet.value(), reader.checksum());
+    reader.expect_checksum<2>();
+    EXPECT_FALSE((bool)error);
+
+    // A truncated checksum field
+    reader.expect_checksum<2>();
+    EXPECT_EQ(bnb::error::truncated, error);
+}
+
+TEST(test_checksum, checksum_reader_seek_back)
+{
+    std::vector<uint8_t> data {1, 2, 3, 4, 5, 6};
+    std::error_code error;
+    bnb::checksum_reader<bnb::crc32, endian::big_endian> reader(
+        data.data(), data.size(), error);
+
+    reader.skip(4);
+    reader.checksum();
+    EXPECT_FALSE((bool)error);
+
+    // The checksum can't be computed after seeking back over its bytes
+    reader.seek(2);
+    reader.expect_checksum<2>();
+    EXPECT_EQ(bnb::error::invalid_seek, error);
+}
+
+TEST(test_checksum, checksum_reader_seek_back_and_forward)
+{
+    std::vector<uint8_t> data {1, 2, 3, 4, 5, 6};
+    bnb::crc32 crc;
+    crc.update(data.data(), 4);
+
+    std::error_code error;
+    bnb::checksum_reader<bnb::crc32, endian::big_endian> reader(
+        data.data(), data.size(), error);
+
+    // Bytes consumed since the last checksum can be read again, they are
+    // only added once
+    reader.skip(3);
+    reader.seek(1);
+    reader.skip(3);
+    EXPECT_EQ(crc.value(), reader.checksum());
+    EXPECT_FALSE((bool)error);
+
+    // Seeking back over the added bytes is detected, also if the read
+    // position is moved past them again before the next checksum
+    reader.seek(2);
+    EXPECT_EQ(bnb::error::invalid_seek, error);
+    reader.skip(2);
+    EXPECT_EQ(bnb::error::invalid_seek, error);
+}
+
+TEST(test_checksum, checksum_reader_policies)
+{
+    std::vector<uint8_t> data {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    bnb::crc32 crc;
+    crc.update(data.data(), data.size());
+    uint32_t value = crc.value();
+    for (uint32_t shift : {24, 16, 8, 0})
+        data.push_back((uint8_t)(value >> shift));
+    data.back() ^= 1;
+
+    bnb::status error;
+    bnb::diagnostic_recorder recorder;
+    bnb::checksum_reader<bnb::crc32, endian::big_endian,
+                         bnb::diagnostic_recorder, bnb::no_stats,
+                         bnb::status> reader(
+        data.data(), data.size(), error, recorder);
+
+    reader.skip(9);
+    reader.expect_checksum<4>();
+    EXPECT_EQ(bnb::error::unexpected_value, error.value());
+    ASSERT_TRUE(recorder.has_diagnostic());
+    EXPECT_EQ(9U, recorder.diagnostic().position);
+}
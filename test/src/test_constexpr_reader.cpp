@@ -0,0 +1,148 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/constexpr_reader.hpp>
+
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// A descriptor table: a 16-bit count followed by entries of an 8-bit id and
+// a byte with a 3-bit type and a 5-bit length
+constexpr uint8_t table[] = {0x00, 0x03, 0x01, 0x24, 0x02, 0x45, 0x07, 0xFF};
+
+struct entry
+{
+    uint8_t id;
+    uint8_t type;
+    uint8_t length;
+};
+
+struct descriptors
+{
+    entry entries[4];
+    uint32_t count;
+    bnb::error error;
+};
+
+template<class Endianness>
+constexpr descriptors parse(const uint8_t* data, uint64_t size)
+{
+    descriptors result = {};
+    bnb::constexpr_reader<Endianness> reader(data, size);
+
+    reader.template read_bytes<2>(result.count).expect_le(4);
+    for (uint32_t i = 0; i < result.count && reader.error() == bnb::error();
+         ++i)
+    {
+        entry& e = result.entries[i];
+        reader.template read_bytes<1>(e.id).expect_ne(0);
+        reader.template read_bits<bitter::u8, bitter::msb0, 3, 5>()
+        .template get<0>(e.type)
+        .template get<1>(e.length).expect_gt(0);
+    }
+
+    result.error = reader.error();
+    return result;
+}
+
+constexpr descriptors parsed = parse<endian::big_endian>(table, sizeof(table));
+static_assert(parsed.error == bnb::error(), "The table must parse");
+static_assert(parsed.count == 3, "");
+static_assert(parsed.entries[1].id == 2, "");
+static_assert(parsed.entries[1].type == 2, "");
+static_assert(parsed.entries[1].length == 5, "");
+static_assert(parsed.entries[2].length == 31, "");
+
+// In little endian the count is 0x0300, which fails the expect_le
+static_assert(parse<endian::little_endian>(table, sizeof(table)).error ==
+              bnb::error::value_out_of_range, "");
+
+// The table cut after the second entry
+static_assert(parse<endian::big_endian>(table, 6).error ==
+              bnb::error::truncated, "");
+
+constexpr uint64_t read_values()
+{
+    bnb::constexpr_reader<endian::little_endian> reader(table);
+    uint64_t value = 0;
+    uint32_t peeked = 0;
+    reader.peek_bytes<3>(peeked, 5);
+    reader.skip(1);
+    reader.read_bytes<4>(value);
+    reader.read_bits<bitter::u16, bitter::lsb0, 4, 12>().get<1>().expect_eq(
+        0x074);
+    return reader.error() == bnb::error() ? value + peeked : 0;
+}
+
+static_assert(read_values() == 0x02240103 + 0xFF0745, "");
+
+// A validator stored from a temporary bit reader holds a copy of it
+constexpr uint32_t read_stored()
+{
+    bnb::constexpr_reader<endian::big_endian> reader(table);
+    uint8_t type = 0;
+    uint8_t length = 0;
+    reader.skip(3);
+    auto validator =
+        reader.read_bits<bitter::u8, bitter::msb0, 3, 5>().get<0>(type);
+    validator.get<1>(length);
+    return reader.error() == bnb::error() ? type * 100U + length : 0;
+}
+
+static_assert(read_stored() == 104, "");
+}
+
+TEST(test_constexpr_reader, runtime)
+{
+    // The same code runs on a runtime buffer
+    std::vector<uint8_t> data(table, table + sizeof(table));
+    auto result = parse<endian::big_endian>(data.data(), data.size());
+    EXPECT_EQ(bnb::error(), result.error);
+    EXPECT_EQ(3U, result.count);
+    EXPECT_EQ(7U, result.entries[2].id);
+    EXPECT_EQ(7U, result.entries[2].type);
+
+    data[4] = 0;
+    result = parse<endian::big_endian>(data.data(), data.size());
+    EXPECT_EQ(bnb::error::unexpected_value, result.error);
+}
+
+TEST(test_constexpr_reader, errors)
+{
+    bnb::constexpr_reader<endian::big_endian> reader(table);
+    EXPECT_FALSE((bool)reader.error_code());
+
+    uint8_t raw[2] = {};
+    reader.seek(6);
+    reader.read(raw, sizeof(raw));
+    EXPECT_EQ(0x07U, raw[0]);
+    EXPECT_EQ(0xFFU, raw[1]);
+    EXPECT_EQ(0U, reader.remaining_size());
+
+    reader.seek(9);
+    EXPECT_EQ(bnb::error::invalid_seek, reader.error());
+    EXPECT_EQ(bnb::error::invalid_seek, reader.error_code());
+
+    // The error is sticky
+    reader.seek(0);
+    EXPECT_EQ(8U, reader.position());
+}
+
+TEST(test_constexpr_reader, floating_point_validator)
+{
+    bnb::error error = bnb::error();
+    bnb::constexpr_validator<double> validator(
+        bnb::detail::constexpr_empty(), 1.5, error);
+    validator.expect_gt(1.0).expect_lt(2.0);
+    EXPECT_EQ(bnb::error(), error);
+
+    validator.expect_eq(2.5);
+    EXPECT_EQ(bnb::error::unexpected_value, error);
+}
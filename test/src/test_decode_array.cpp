@@ -0,0 +1,57 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/decode_array.hpp>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+template<class Endianness, uint8_t Bytes, class ValueType>
+void check_decode_array(uint64_t count)
+{
+    std::vector<uint8_t> buffer(count * Bytes);
+    for (uint32_t i = 0; i < buffer.size(); ++i)
+        buffer[i] = (uint8_t)(rand() % 256);
+
+    std::vector<ValueType> values(count);
+    bnb::decode_array<Endianness, Bytes>(
+        buffer.data(), values.data(), count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ValueType expected;
+        Endianness::template get_bytes<Bytes, ValueType>(
+            expected, buffer.data() + i * Bytes);
+        EXPECT_EQ(expected, values[i]) << "index " << i;
+    }
+}
+
+template<class Endianness>
+void check_decode_array_sizes()
+{
+    // Cover the vectorized body as well as the scalar tail
+    for (uint64_t count : {0U, 1U, 3U, 7U, 8U, 16U, 33U, 100U})
+    {
+        check_decode_array<Endianness, 2, uint16_t>(count);
+        check_decode_array<Endianness, 4, uint32_t>(count);
+        check_decode_array<Endianness, 8, uint64_t>(count);
+        check_decode_array<Endianness, 4, int32_t>(count);
+        check_decode_array<Endianness, 3, uint32_t>(count);
+        check_decode_array<Endianness, 2, uint64_t>(count);
+    }
+}
+}
+
+TEST(test_decode_array, big_endian)
+{
+    check_decode_array_sizes<endian::big_endian>();
+}
+
+TEST(test_decode_array, little_endian)
+{
+    check_decode_array_sizes<endian::little_endian>();
+}
@@ -0,0 +1,153 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/diagnostics.hpp>
+#include <bnb/stream_reader.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_diagnostics, error_codes)
+{
+    std::error_code error = bnb::error::truncated;
+    EXPECT_EQ(std::string("bnb"), error.category().name());
+    EXPECT_EQ(std::errc::result_out_of_range, error);
+    EXPECT_NE(bnb::error::unexpected_value, error);
+
+    EXPECT_EQ(std::errc::invalid_seek,
+              std::error_code(bnb::error::invalid_seek));
+    EXPECT_EQ(std::errc::illegal_byte_sequence,
+              std::error_code(bnb::error::invalid_varint));
+    EXPECT_EQ(std::errc::value_too_large,
+              std::error_code(bnb::error::value_too_large));
+    EXPECT_EQ(std::errc::result_out_of_range,
+              std::error_code(bnb::error::predicate_failed));
+    EXPECT_EQ(std::errc::invalid_argument,
+              std::error_code(bnb::error::invalid_size));
+}
+
+TEST(test_diagnostics, distinct_codes)
+{
+    std::vector<uint8_t> buffer {0x01, 0x02, 0x03};
+
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+        reader.read_bytes<4>();
+        EXPECT_EQ(bnb::error::truncated, error);
+    }
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+        reader.read_bytes<1>().expect_eq(2);
+        EXPECT_EQ(bnb::error::unexpected_value, error);
+    }
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+        reader.read_bytes<1>().expect_in_range<2, 4>();
+        EXPECT_EQ(bnb::error::value_out_of_range, error);
+    }
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+        reader.read_bytes<1>().expect([](uint64_t v) { return v == 0; });
+        EXPECT_EQ(bnb::error::predicate_failed, error);
+    }
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+        reader.skip(4);
+        EXPECT_EQ(bnb::error::invalid_seek, error);
+    }
+}
+
+TEST(test_diagnostics, no_diagnostics)
+{
+    // The default policy adds nothing to the validators
+    EXPECT_EQ(sizeof(bnb::detail::diagnostics_context<bnb::no_diagnostics>),
+              1U);
+}
+
+TEST(test_diagnostics, expect_eq)
+{
+    std::vector<uint8_t> buffer {0x01, 0x02, 0x03, 0x04};
+    std::error_code error;
+    bnb::diagnostic_recorder diagnostics;
+    bnb::stream_reader<endian::big_endian, bnb::diagnostic_recorder> reader(
+        buffer.data(), buffer.size(), error, diagnostics);
+
+    reader.field("type").read_bytes<1>().expect_eq(1);
+    reader.field("version").read_bytes<2>().expect_eq(0x0200);
+    reader.field("length").read_bytes<1>();
+
+    ASSERT_TRUE(diagnostics.has_diagnostic());
+    const auto& diagnostic = diagnostics.diagnostic();
+    EXPECT_EQ(bnb::error::unexpected_value, diagnostic.error);
+    EXPECT_EQ(bnb::diagnostic_kind::expect_eq, diagnostic.kind);
+    EXPECT_EQ(1U, diagnostic.position);
+    EXPECT_EQ(0U, diagnostic.bit_offset);
+    EXPECT_STREQ("version", diagnostic.field);
+    EXPECT_EQ(0x0203U, diagnostic.actual);
+    EXPECT_EQ(0x0200U, diagnostic.expected);
+}
+
+TEST(test_diagnostics, truncated)
+{
+    std::vector<uint8_t> buffer {0x01, 0x02, 0x03, 0x04, 0x05};
+    std::error_code error;
+    bnb::diagnostic_recorder diagnostics;
+    bnb::stream_reader<endian::big_endian, bnb::diagnostic_recorder> reader(
+        buffer.data(), buffer.size(), error, diagnostics);
+
+    reader.read_bytes<1>();
+    auto sub_reader = reader.skip(3);
+    sub_reader.read_bytes<2>();
+    sub_reader.field("payload").read_bytes<2>();
+
+    ASSERT_TRUE(diagnostics.has_diagnostic());
+    const auto& diagnostic = diagnostics.diagnostic();
+    EXPECT_EQ(bnb::error::truncated, diagnostic.error);
+    EXPECT_EQ(bnb::diagnostic_kind::read, diagnostic.kind);
+    EXPECT_EQ(3U, diagnostic.position);
+    EXPECT_STREQ("payload", diagnostic.field);
+    EXPECT_EQ(1U, diagnostic.actual);
+    EXPECT_EQ(2U, diagnostic.expected);
+}
+
+TEST(test_diagnostics, bit_fields)
+{
+    std::vector<uint8_t> buffer {0x00, 0x4F};
+    std::error_code error;
+    bnb::diagnostic_recorder diagnostics;
+    bnb::stream_reader<endian::big_endian, bnb::diagnostic_recorder> reader(
+        buffer.data(), buffer.size(), error, diagnostics);
+
+    reader.read_bytes<1>();
+    reader.field("flags").read_bits<bitter::u8, bitter::msb0, 1, 3, 4>()
+        .get<0>().expect_eq(0)
+        .get<1>().expect_in_range<1, 3>()
+        .get<2>();
+
+    ASSERT_TRUE(diagnostics.has_diagnostic());
+    const auto& diagnostic = diagnostics.diagnostic();
+    EXPECT_EQ(bnb::error::value_out_of_range, diagnostic.error);
+    EXPECT_EQ(bnb::diagnostic_kind::expect_in_range, diagnostic.kind);
+    EXPECT_EQ(1U, diagnostic.position);
+    EXPECT_EQ(1U, diagnostic.bit_offset);
+    EXPECT_STREQ("flags", diagnostic.field);
+    EXPECT_EQ(4U, diagnostic.actual);
+    EXPECT_EQ(1U, diagnostic.expected);
+    EXPECT_EQ(3U, diagnostic.expected_max);
+}
@@ -0,0 +1,188 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/layout.hpp>
+#include <bnb/stream_reader.hpp>
+#include <bnb/stream_writer.hpp>
+#include <endian/big_endian.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+using header = bnb::layout<
+    bnb::field<2>,
+    bnb::field<4>,
+    bnb::bits<bitter::u8, bitter::msb0, 3, 5>,
+    bnb::field<3>>;
+
+using checked_header = bnb::layout<
+    bnb::checked<bnb::field<2>, bnb::eq<1>>,
+    bnb::checked<bnb::field<4>, bnb::ge<0x100>, bnb::le<0xFFFFFF>>,
+    bnb::checked<bnb::bits<bitter::u8, bitter::msb0, 3, 5>,
+                 bnb::element<0, bnb::in_range<4, 6>>,
+                 bnb::element<1, bnb::ne<0>>>,
+    bnb::field<3>>;
+}
+
+TEST(test_layout, size)
+{
+    EXPECT_EQ(10U, header::size);
+    EXPECT_TRUE((std::is_same<
+        std::tuple<uint16_t, uint32_t, std::array<uint8_t, 2>, uint32_t>,
+        header::value_type>::value));
+}
+
+TEST(test_layout, read_layout)
+{
+    std::vector<uint8_t> buffer
+        {0, 1, 2, 3, 4, 5, 0b10100011, 6, 7, 8, 9};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    header::value_type values;
+    reader.read_layout<header>(values);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(10U, reader.position());
+
+    EXPECT_EQ(0x0001U, std::get<0>(values));
+    EXPECT_EQ(0x02030405U, std::get<1>(values));
+    EXPECT_EQ(5U, std::get<2>(values)[0]);
+    EXPECT_EQ(3U, std::get<2>(values)[1]);
+    EXPECT_EQ(0x060708U, std::get<3>(values));
+
+    // Too little data left for another header
+    header::value_type more_values {1, 2, {{3, 4}}, 5};
+    reader.read_layout<header>(more_values);
+    EXPECT_TRUE((bool)error);
+    EXPECT_EQ(header::value_type(1, 2, {{3, 4}}, 5), more_values);
+}
+
+TEST(test_layout, read_layout_tie)
+{
+    std::vector<uint8_t> buffer
+        {0, 1, 2, 3, 4, 5, 0b10100011, 6, 7, 8};
+    std::error_code error;
+    bnb::stream_reader<endian::little_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    uint64_t first = 0;
+    uint32_t second = 0;
+    std::array<uint32_t, 2> third;
+    uint32_t fourth = 0;
+    reader.read_layout<header>(std::tie(first, second, third, fourth));
+    EXPECT_FALSE((bool)error);
+
+    EXPECT_EQ(0x0100U, first);
+    EXPECT_EQ(0x05040302U, second);
+    EXPECT_EQ(5U, third[0]);
+    EXPECT_EQ(3U, third[1]);
+    EXPECT_EQ(0x080706U, fourth);
+}
+
+TEST(test_layout, read_checked_layout)
+{
+    std::vector<uint8_t> buffer
+        {0, 1, 0, 3, 4, 5, 0b10100011, 6, 7, 8,
+         0, 1, 0, 3, 4, 5, 0b10100000, 6, 7, 8};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    EXPECT_EQ(header::size, checked_header::size);
+    EXPECT_TRUE((std::is_same<header::value_type,
+                              checked_header::value_type>::value));
+
+    checked_header::value_type values;
+    reader.read_layout<checked_header>(values);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(0x00030405U, std::get<1>(values));
+
+    // The second bit field of the second header is zero
+    reader.read_layout<checked_header>(values);
+    EXPECT_EQ(bnb::error::unexpected_value, error);
+    EXPECT_EQ(0U, std::get<2>(values)[1]);
+}
+
+TEST(test_layout, check)
+{
+    checked_header::value_type values {1, 0x100, {{5, 1}}, 0};
+    EXPECT_TRUE(checked_header::check(values));
+    EXPECT_TRUE(header::check(values));
+
+    std::get<0>(values) = 2;
+    EXPECT_FALSE(checked_header::check(values));
+    EXPECT_TRUE(header::check(values));
+
+    std::get<0>(values) = 1;
+    std::get<1>(values) = 0x1000000;
+    EXPECT_FALSE(checked_header::check(values));
+
+    std::get<1>(values) = 0xFFFFFF;
+    std::get<2>(values)[0] = 3;
+    EXPECT_FALSE(checked_header::check(values));
+
+    std::get<2>(values)[0] = 6;
+    EXPECT_TRUE(checked_header::check(values));
+}
+
+TEST(test_layout, write_layout)
+{
+    std::vector<uint8_t> buffer(15);
+    std::error_code error;
+    bnb::stream_writer<endian::big_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    checked_header::value_type values {1, 0x00030405, {{5, 3}}, 0x060708};
+    writer.write_layout<checked_header>(values);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(10U, writer.position());
+    EXPECT_EQ(std::vector<uint8_t>(
+        {0, 1, 0, 3, 4, 5, 0b10100011, 6, 7, 8, 0, 0, 0, 0, 0}), buffer);
+
+    // The written layout reads back to the same values
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+    checked_header::value_type read_values;
+    reader.read_layout<checked_header>(read_values);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(values, read_values);
+
+    // Too little space left for another header
+    writer.write_layout<checked_header>(values);
+    EXPECT_EQ(bnb::error::truncated, error);
+    EXPECT_EQ(0U, buffer[10]);
+}
+
+TEST(test_layout, write_layout_check_failed)
+{
+    std::vector<uint8_t> buffer(10);
+    std::error_code error;
+    bnb::stream_writer<endian::big_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    // The first field must be 1
+    checked_header::value_type values {2, 0x00030405, {{5, 3}}, 0x060708};
+    writer.write_layout<checked_header>(values);
+    EXPECT_EQ(bnb::error::unexpected_value, error);
+    EXPECT_EQ(std::vector<uint8_t>(10, 0), buffer);
+}
+
+TEST(test_layout, write_layout_tie)
+{
+    std::vector<uint8_t> buffer(10);
+    std::error_code error;
+    bnb::stream_writer<endian::little_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    uint64_t first = 0x0100;
+    uint32_t second = 0x05040302;
+    std::array<uint32_t, 2> third {{5, 3}};
+    uint32_t fourth = 0x080706;
+    writer.write_layout<header>(std::tie(first, second, third, fourth));
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(std::vector<uint8_t>(
+        {0, 1, 2, 3, 4, 5, 0b10100011, 6, 7, 8}), buffer);
+}
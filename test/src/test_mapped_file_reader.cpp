@@ -0,0 +1,79 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/mapped_file_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+void write_file(const std::string& path, const std::vector<uint8_t>& data)
+{
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*)data.data(), data.size());
+}
+}
+
+TEST(test_mapped_file_reader, read)
+{
+    std::string path = "test_mapped_file_reader.bin";
+    write_file(path, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+    {
+        std::error_code error;
+        bnb::mapped_file_options options;
+        options.will_need = true;
+        options.populate = true;
+        bnb::mapped_file_reader<endian::big_endian> reader(
+            path, error, options);
+        ASSERT_FALSE((bool)error);
+        EXPECT_EQ(10U, reader.size());
+
+        reader.read_bytes<2>().expect_eq(0x0001U);
+        auto skipped = reader.skip(4);
+        skipped.read_bytes<4>().expect_eq(0x02030405U);
+        reader.read_bytes<4>().expect_eq(0x06070809U);
+        EXPECT_FALSE((bool)error);
+
+        reader.read_bytes<1>();
+        EXPECT_TRUE((bool)error);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(test_mapped_file_reader, empty_file)
+{
+    std::string path = "test_mapped_file_reader_empty.bin";
+    write_file(path, {});
+
+    {
+        std::error_code error;
+        bnb::mapped_file_reader<endian::big_endian> reader(path, error);
+        EXPECT_FALSE((bool)error);
+        EXPECT_EQ(0U, reader.size());
+
+        reader.read_bytes<1>();
+        EXPECT_TRUE((bool)error);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(test_mapped_file_reader, missing_file)
+{
+    std::error_code error;
+    bnb::mapped_file_reader<endian::big_endian> reader(
+        "test_mapped_file_reader_missing.bin", error);
+    EXPECT_EQ(std::errc::no_such_file_or_directory, error);
+    EXPECT_EQ(0U, reader.size());
+
+    // Make sure we can still read without crashing
+    reader.read_bytes<1>();
+    EXPECT_TRUE((bool)error);
+}
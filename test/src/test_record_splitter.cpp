@@ -0,0 +1,194 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/record_splitter.hpp>
+#include <endian/big_endian.hpp>
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Creates records with a 2 byte length prefix, each holding a 4 byte value
+// equal to the index of the record, except for every 10th record which is
+// only 2 bytes and thus malformed.
+std::vector<uint8_t> make_records(uint32_t count)
+{
+    std::vector<uint8_t> buffer;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint8_t size = i % 10 == 9 ? 2 : 4;
+        buffer.push_back(0);
+        buffer.push_back(size);
+        for (uint32_t j = 0; j < size; ++j)
+            buffer.push_back((uint8_t)(i >> (8 * (size - 1 - j))));
+    }
+    return buffer;
+}
+}
+
+TEST(test_record_splitter, split_records)
+{
+    std::vector<uint8_t> buffer {0, 2, 1, 2, 0, 0, 0, 1, 3};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto records = bnb::split_records<2>(reader);
+    EXPECT_FALSE((bool)error);
+    ASSERT_EQ(3U, records.size());
+    EXPECT_EQ(buffer.data() + 2, records[0].data);
+    EXPECT_EQ(2U, records[0].size);
+    EXPECT_EQ(0U, records[1].size);
+    EXPECT_EQ(buffer.data() + 8, records[2].data);
+    EXPECT_EQ(1U, records[2].size);
+}
+
+TEST(test_record_splitter, split_records_truncated)
+{
+    std::vector<uint8_t> buffer {0, 2, 1, 2, 0, 3, 1};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto records = bnb::split_records<2>(reader);
+    EXPECT_TRUE((bool)error);
+    EXPECT_EQ(1U, records.size());
+}
+
+TEST(test_record_splitter, parse_records)
+{
+    const uint32_t count = 1000;
+    auto buffer = make_records(count);
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto records = bnb::split_records<2>(reader);
+    ASSERT_FALSE((bool)error);
+    ASSERT_EQ(count, records.size());
+
+    for (uint32_t threads : {1U, 4U, 0U})
+    {
+        uint64_t delivered = 0;
+        bnb::parse_records<endian::big_endian>(records,
+            [](bnb::stream_reader<endian::big_endian>& record)
+            {
+                uint32_t value = 0;
+                record.read_bytes<4>(value);
+                return value;
+            },
+            [&](uint64_t index, uint32_t value, const std::error_code& e)
+            {
+                EXPECT_EQ(delivered, index);
+                if (index % 10 == 9)
+                {
+                    EXPECT_TRUE((bool)e);
+                }
+                else
+                {
+                    EXPECT_FALSE((bool)e);
+                    EXPECT_EQ(index, value);
+                }
+                delivered++;
+            },
+            threads);
+
+        EXPECT_EQ(count, delivered);
+    }
+}
+
+TEST(test_record_splitter, parse_records_bool)
+{
+    const uint32_t count = 1000;
+    auto buffer = make_records(count);
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto records = bnb::split_records<2>(reader);
+    ASSERT_EQ(count, records.size());
+
+    // Neighbouring bool results are written by different threads
+    uint64_t delivered = 0;
+    bnb::parse_records<endian::big_endian>(records,
+        [](bnb::stream_reader<endian::big_endian>& record)
+        {
+            uint32_t value = 0;
+            record.read_bytes<4>(value);
+            return value % 2 == 1;
+        },
+        [&](uint64_t index, bool odd, const std::error_code& e)
+        {
+            EXPECT_EQ(delivered, index);
+            if (!e)
+            {
+                EXPECT_EQ(index % 2 == 1, odd);
+            }
+            delivered++;
+        },
+        4);
+
+    EXPECT_EQ(count, delivered);
+}
+
+TEST(test_record_splitter, parse_records_throw)
+{
+    const uint32_t count = 1000;
+    auto buffer = make_records(count);
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto records = bnb::split_records<2>(reader);
+    ASSERT_EQ(count, records.size());
+
+    auto decode = [](bnb::stream_reader<endian::big_endian>& record)
+    {
+        uint32_t value = 0;
+        record.read_bytes<4>(value);
+        if (value == 500)
+            throw std::runtime_error("decode");
+        return value;
+    };
+
+    // The exception is rethrown whether the record was decoded by a worker
+    // thread or by the calling thread, after the earlier records
+    for (uint32_t threads : {1U, 4U})
+    {
+        uint64_t delivered = 0;
+        EXPECT_THROW(bnb::parse_records<endian::big_endian>(records, decode,
+            [&](uint64_t, uint32_t, const std::error_code&)
+            {
+                delivered++;
+            },
+            threads), std::runtime_error);
+        EXPECT_GE(500U, delivered);
+    }
+
+    // The workers are stopped and joined if deliver throws
+    uint64_t delivered = 0;
+    EXPECT_THROW(bnb::parse_records<endian::big_endian>(records,
+        [](bnb::stream_reader<endian::big_endian>&) { return 0; },
+        [&](uint64_t index, int, const std::error_code&)
+        {
+            if (index == 100)
+                throw std::runtime_error("deliver");
+            delivered++;
+        },
+        4), std::runtime_error);
+    EXPECT_EQ(100U, delivered);
+}
+
+TEST(test_record_splitter, parse_no_records)
+{
+    std::vector<bnb::record_span> records;
+    bool delivered = false;
+    bnb::parse_records<endian::big_endian>(records,
+        [](bnb::stream_reader<endian::big_endian>&) { return 0; },
+        [&](uint64_t, int, const std::error_code&) { delivered = true; });
+    EXPECT_FALSE(delivered);
+}
@@ -0,0 +1,145 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/resumable_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_resumable_reader, need_more_data)
+{
+    std::vector<uint8_t> buffer {0, 1, 2};
+    std::error_code error;
+    bnb::resumable_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    reader.read_bytes<2>().expect_eq(1U);
+    EXPECT_FALSE(reader.need_more_data());
+
+    uint32_t value = 42;
+    reader.read_bytes<4>(value);
+    EXPECT_TRUE(reader.need_more_data());
+    EXPECT_EQ(bnb::error::need_more_data, error);
+    EXPECT_EQ(6U, reader.needed_size());
+    EXPECT_EQ(42U, value);
+
+    // The error code still matches the generic error condition
+    EXPECT_EQ(std::errc::result_out_of_range, error);
+    EXPECT_EQ("bnb", std::string(error.category().name()));
+}
+
+TEST(test_resumable_reader, malformed)
+{
+    std::vector<uint8_t> buffer {0, 1, 2};
+    std::error_code error;
+    bnb::resumable_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    reader.read_bytes<1>().expect_eq(1U);
+    EXPECT_TRUE((bool)error);
+    EXPECT_FALSE(reader.need_more_data());
+
+    // Malformed data is not cleared when resuming
+    reader.resume(buffer.data(), buffer.size());
+    EXPECT_TRUE((bool)error);
+}
+
+TEST(test_resumable_reader, skip)
+{
+    std::vector<uint8_t> buffer {0, 1, 2, 3};
+    std::error_code error;
+    bnb::resumable_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    // Reading past the end of a skipped part means the data is malformed
+    auto skipped = reader.skip(2);
+    skipped.read_bytes<4>();
+    EXPECT_TRUE((bool)error);
+    EXPECT_FALSE(reader.need_more_data());
+
+    // Skipping past the end of the data means more data is needed
+    std::error_code skip_error;
+    bnb::resumable_reader<endian::big_endian> skip_reader(
+        buffer.data(), buffer.size(), skip_error);
+    skip_reader.skip(10);
+    EXPECT_TRUE(skip_reader.need_more_data());
+    EXPECT_EQ(10U, skip_reader.needed_size());
+}
+
+TEST(test_resumable_reader, resume)
+{
+    // Three length prefixed records
+    std::vector<uint8_t> stream
+        {0, 2, 'a', 'b', 0, 3, 'c', 'd', 'e', 0, 1, 'f'};
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(stream.size());
+    std::vector<std::string> records;
+    uint32_t parsed_lengths = 0;
+
+    std::error_code error;
+    bnb::resumable_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    // Deliver the stream in chunks of 3 bytes
+    for (uint32_t offset = 0; offset < stream.size(); offset += 3)
+    {
+        buffer.insert(buffer.end(), stream.begin() + offset,
+                      stream.begin() + offset + 3);
+        reader.resume(buffer.data(), buffer.size());
+        EXPECT_FALSE((bool)error);
+
+        while (!error && reader.remaining_size() > 0)
+        {
+            uint16_t length = 0;
+            reader.read_bytes<2>(length);
+            if (error)
+                break;
+            parsed_lengths++;
+
+            std::string record(length, '\0');
+            reader.read((uint8_t*)&record[0], length);
+            if (error)
+                break;
+
+            records.push_back(record);
+            reader.checkpoint();
+        }
+    }
+
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(std::vector<std::string>({"ab", "cde", "f"}), records);
+    EXPECT_EQ(stream.size(), reader.checkpoint_position());
+
+    // Only the lengths of the first two records were parsed twice, as chunks
+    // ended in their payloads. Completed records are never parsed again.
+    EXPECT_EQ(5U, parsed_lengths);
+}
+
+TEST(test_resumable_reader, resume_discarded)
+{
+    std::vector<uint8_t> stream {0, 1, 2, 3, 4, 5};
+    std::error_code error;
+    bnb::resumable_reader<endian::big_endian> reader(
+        stream.data(), 4, error);
+
+    reader.read_bytes<2>().expect_eq(0x0001U);
+    reader.checkpoint();
+    reader.read_bytes<4>();
+    EXPECT_TRUE(reader.need_more_data());
+    EXPECT_EQ(6U, reader.needed_size());
+
+    // Drop the consumed bytes from the front of the buffer
+    std::vector<uint8_t> remaining(stream.begin() + 2, stream.end());
+    reader.resume(remaining.data(), remaining.size(), 2);
+    reader.read_bytes<4>().expect_eq(0x02030405U);
+    EXPECT_FALSE((bool)error);
+}
+
+TEST(test_resumable_reader, no_cost_when_not_resumable)
+{
+    // Only the resumable reader holds the state for resuming
+    EXPECT_LT(sizeof(bnb::stream_reader<endian::big_endian>),
+              sizeof(bnb::resumable_reader<endian::big_endian>));
+}
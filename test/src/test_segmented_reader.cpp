@@ -0,0 +1,169 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/segmented_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+// Splits {0, 1, ..., 9} into the segments {0, 1, 2} {} {3} {4, 5, 6, 7, 8, 9}
+struct segmented_buffer
+{
+    std::vector<uint8_t> first {0, 1, 2};
+    std::vector<uint8_t> second {3};
+    std::vector<uint8_t> third {4, 5, 6, 7, 8, 9};
+
+    std::vector<bnb::segment> segments
+    {
+        {first.data(), first.size()},
+        {nullptr, 0},
+        {second.data(), second.size()},
+        {third.data(), third.size()}
+    };
+};
+}
+
+TEST(test_segmented_reader, init)
+{
+    segmented_buffer buffer;
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(
+        buffer.segments.data(), buffer.segments.size(), error);
+
+    ASSERT_FALSE((bool)error);
+    EXPECT_EQ(10U, reader.size());
+    EXPECT_EQ(10U, reader.remaining_size());
+    EXPECT_EQ(0U, reader.position());
+}
+
+TEST(test_segmented_reader, read_bytes)
+{
+    segmented_buffer buffer;
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(
+        buffer.segments.data(), buffer.segments.size(), error);
+
+    uint16_t bytes01 = 0;
+    uint32_t bytes2345 = 0;
+    uint8_t byte6 = 0;
+    uint32_t bytes789 = 0;
+
+    reader.read_bytes<2>(bytes01);
+    reader.read_bytes<4>(bytes2345);
+    reader.read_bytes<1>(byte6);
+    reader.read_bytes<3>(bytes789);
+    EXPECT_FALSE((bool)error);
+
+    EXPECT_EQ(0x0001U, bytes01);
+    EXPECT_EQ(0x02030405U, bytes2345);
+    EXPECT_EQ(6U, byte6);
+    EXPECT_EQ(0x070809U, bytes789);
+    EXPECT_EQ(10U, reader.position());
+
+    // read out of bounds
+    uint8_t initial_value = 88;
+    uint8_t byte10 = initial_value;
+    reader.read_bytes<1>(byte10);
+    EXPECT_TRUE((bool)error);
+    EXPECT_EQ(initial_value, byte10);
+}
+
+TEST(test_segmented_reader, peek_bytes)
+{
+    segmented_buffer buffer;
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(
+        buffer.segments.data(), buffer.segments.size(), error);
+
+    reader.peek_bytes<2>(1).expect_eq(0x0102U);
+    reader.peek_bytes<4>(2).expect_eq(0x02030405U);
+    reader.peek_bytes<1>(9).expect_eq(9U);
+    reader.read_bytes<1>().expect_eq(0U);
+    reader.peek_bytes<8>(1).expect_eq(0x0203040506070809U);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(1U, reader.position());
+
+    reader.peek_bytes<1>(9);
+    EXPECT_TRUE((bool)error);
+}
+
+TEST(test_segmented_reader, peek_bytes_offset_overflow)
+{
+    segmented_buffer buffer;
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(
+        buffer.segments.data(), buffer.segments.size(), error);
+
+    reader.peek_bytes<1>(UINT64_MAX);
+    EXPECT_TRUE((bool)error);
+}
+
+TEST(test_segmented_reader, read)
+{
+    segmented_buffer buffer;
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(
+        buffer.segments.data(), buffer.segments.size(), error);
+
+    std::vector<uint8_t> data(8);
+    reader.read_bytes<1>();
+    reader.read(data.data(), data.size());
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3, 4, 5, 6, 7, 8}), data);
+
+    reader.read(data.data(), 2);
+    EXPECT_TRUE((bool)error);
+}
+
+TEST(test_segmented_reader, read_bits)
+{
+    segmented_buffer buffer;
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(
+        buffer.segments.data(), buffer.segments.size(), error);
+
+    reader.read_bytes<2>();
+    reader.read_bits<bitter::u16, bitter::msb0, 8, 8>()
+    .get<0>().expect_eq(2U)
+    .get<1>().expect_eq(3U);
+    EXPECT_FALSE((bool)error);
+}
+
+TEST(test_segmented_reader, skip)
+{
+    segmented_buffer buffer;
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(
+        buffer.segments.data(), buffer.segments.size(), error);
+
+    reader.read_bytes<1>();
+    auto skipped = reader.skip(5);
+    EXPECT_EQ(5U, skipped.size());
+    EXPECT_EQ(6U, reader.position());
+
+    skipped.read_bytes<4>().expect_eq(0x01020304U);
+    skipped.read_bytes<1>().expect_eq(5U);
+    reader.read_bytes<4>().expect_eq(0x06070809U);
+    EXPECT_FALSE((bool)error);
+
+    // The skipped reader can't read past the skipped bytes
+    skipped.read_bytes<1>();
+    EXPECT_TRUE((bool)error);
+
+    auto reader_with_error = reader.skip(1);
+    EXPECT_TRUE((bool)reader_with_error.error());
+}
+
+TEST(test_segmented_reader, empty)
+{
+    std::error_code error;
+    bnb::segmented_reader<endian::big_endian> reader(nullptr, 0, error);
+    EXPECT_EQ(0U, reader.size());
+    reader.skip(0);
+    EXPECT_FALSE((bool)error);
+    reader.read_bytes<1>();
+    EXPECT_TRUE((bool)error);
+}
@@ -0,0 +1,108 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stats.hpp>
+#include <bnb/stream_reader.hpp>
+
+#include <cstdint>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_stats, no_stats)
+{
+    // The default policies add nothing to the readers and validators
+    EXPECT_EQ(1U, sizeof(bnb::detail::reader_context<>));
+}
+
+TEST(test_stats, reader_stats)
+{
+    std::vector<uint8_t> buffer {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+    std::error_code error;
+    bnb::reader_stats stats;
+    bnb::stream_reader<endian::big_endian, bnb::no_diagnostics,
+                       bnb::reader_stats> reader(
+        buffer.data(), buffer.size(), error, stats);
+
+    reader.read_bytes<2>().expect_eq(0x0102);
+    reader.peek_bytes<1>(1);
+    reader.read_bits<bitter::u8, bitter::msb0, 4, 4>().get<0>().get<1>();
+    auto sub_reader = reader.skip(2);
+    sub_reader.read_bytes<1>();
+    reader.read_bytes<1>().expect_lt(7);
+
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(5U, stats.fields());
+    EXPECT_EQ(5U, stats.bytes());
+    EXPECT_EQ(1U, stats.peeks());
+    EXPECT_EQ(1U, stats.skips());
+    EXPECT_EQ(2U, stats.skipped_bytes());
+    EXPECT_EQ(0U, stats.failures());
+
+    reader.read_bytes<1>();
+    EXPECT_EQ(bnb::error::truncated, error);
+    EXPECT_EQ(1U, stats.failures(bnb::diagnostic_kind::read));
+
+    error.clear();
+    reader.seek(5);
+    reader.read_bytes<1>().expect_lt(6);
+    EXPECT_EQ(1U, stats.failures(bnb::diagnostic_kind::expect_lt));
+    EXPECT_EQ(2U, stats.failures());
+
+    bnb::reader_stats total;
+    total += stats;
+    total += stats;
+    EXPECT_EQ(12U, total.fields());
+    total.clear();
+    EXPECT_EQ(0U, total.fields());
+}
+
+TEST(test_stats, diagnostics_and_stats)
+{
+    std::vector<uint8_t> buffer {0x01};
+    std::error_code error;
+    bnb::diagnostic_recorder diagnostics;
+    bnb::reader_stats stats;
+    bnb::stream_reader<endian::big_endian, bnb::diagnostic_recorder,
+                       bnb::reader_stats> reader(
+        buffer.data(), buffer.size(), error, diagnostics, stats);
+
+    reader.read_bytes<1>().expect([](uint64_t value) { return value == 0; });
+
+    EXPECT_EQ(bnb::error::predicate_failed, error);
+    ASSERT_TRUE(diagnostics.has_diagnostic());
+    EXPECT_EQ(bnb::diagnostic_kind::expect, diagnostics.diagnostic().kind);
+    EXPECT_EQ(1U, stats.failures(bnb::diagnostic_kind::expect));
+}
+
+TEST(test_stats, thread_stats)
+{
+    const uint64_t before = bnb::thread_stats::collect().fields();
+
+    std::vector<uint8_t> buffer(64, 0x01);
+    auto parse = [&buffer]()
+    {
+        std::error_code error;
+        bnb::thread_stats stats;
+        bnb::stream_reader<endian::big_endian, bnb::no_diagnostics,
+                           bnb::thread_stats> reader(
+            buffer.data(), buffer.size(), error, stats);
+
+        for (uint32_t i = 0; i < 16; ++i)
+            reader.read_bytes<4>();
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < 4; ++i)
+        threads.emplace_back(parse);
+    parse();
+
+    // Counters of the running main thread and of the exited threads
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(before + 5 * 16, bnb::thread_stats::collect().fields());
+}
@@ -0,0 +1,120 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/status.hpp>
+#include <bnb/stream_reader.hpp>
+
+#include <cstdint>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+template<class Endianness>
+using status_reader =
+    bnb::stream_reader<Endianness, bnb::no_diagnostics, bnb::no_stats,
+                       bnb::status>;
+}
+
+TEST(test_status, status)
+{
+    bnb::status status;
+    EXPECT_FALSE((bool)status);
+    EXPECT_FALSE((bool)status.error_code());
+
+    status.set(bnb::error::truncated);
+    EXPECT_TRUE((bool)status);
+    EXPECT_EQ(bnb::error::truncated, status.value());
+    EXPECT_TRUE(status == bnb::error::truncated);
+    EXPECT_TRUE(status != bnb::error::invalid_seek);
+    EXPECT_EQ(bnb::error::truncated, status.error_code());
+    EXPECT_EQ(std::errc::result_out_of_range, status.error_code());
+
+    status.clear();
+    EXPECT_FALSE((bool)status);
+}
+
+TEST(test_status, stream_reader)
+{
+    std::vector<uint8_t> data {0x01, 0x02, 0x03, 0x04, 0xA5, 0x00, 0x05};
+    bnb::status status;
+    status_reader<endian::big_endian> reader(data.data(), data.size(), status);
+
+    uint16_t value = 0;
+    uint8_t low = 0;
+    uint8_t values[2] = {};
+    reader.read_bytes<2>(value).expect_eq(0x0102);
+    reader.peek_bytes<1>(1).expect_eq(0x04);
+    reader.read_array<1>(values, 2).expect_ge(0x03);
+    reader.read_bits<bitter::u8, bitter::msb0, 4, 4>()
+    .get<0>().expect_eq(0xA)
+    .get<1>(low).expect_lt(6);
+
+    auto window = reader.require(2);
+    window.read_bytes<1>().expect_eq(0);
+    window.read_bytes<1>().expect_in_range<1, 5>();
+    EXPECT_FALSE((bool)status);
+    EXPECT_FALSE((bool)reader.error());
+    EXPECT_EQ(0x0102U, value);
+    EXPECT_EQ(5U, low);
+    EXPECT_EQ(0x04U, values[1]);
+
+    reader.read_bytes<1>();
+    EXPECT_EQ(bnb::error::truncated, status.value());
+    EXPECT_EQ(bnb::error::truncated, reader.error());
+}
+
+TEST(test_status, validators)
+{
+    std::vector<uint8_t> data {0x01, 0x02, 0x03};
+
+    {
+        bnb::status status;
+        status_reader<endian::little_endian> reader(
+            data.data(), data.size(), status);
+        reader.read_bytes<1>().expect_eq(2);
+        EXPECT_EQ(bnb::error::unexpected_value, status.value());
+
+        // The status is sticky
+        reader.read_bytes<1>().expect_eq(2);
+        EXPECT_EQ(bnb::error::unexpected_value, status.value());
+    }
+    {
+        bnb::status status;
+        status_reader<endian::little_endian> reader(
+            data.data(), data.size(), status);
+        uint8_t values[3] = {};
+        reader.read_array<1>(values, 3).expect_lt(3);
+        EXPECT_EQ(bnb::error::value_out_of_range, status.value());
+    }
+    {
+        bnb::status status;
+        status_reader<endian::little_endian> reader(
+            data.data(), data.size(), status);
+        reader.skip(1).read_bytes<2>();
+        EXPECT_EQ(bnb::error::truncated, status.value());
+    }
+}
+
+TEST(test_status, diagnostics)
+{
+    std::vector<uint8_t> data {0x01, 0x02};
+    bnb::status status;
+    bnb::diagnostic_recorder recorder;
+    bnb::stream_reader<endian::big_endian, bnb::diagnostic_recorder,
+                       bnb::no_stats, bnb::status>
+    reader(data.data(), data.size(), status, recorder);
+
+    reader.read_bytes<1>();
+    reader.field("length").read_bytes<1>().expect_le(1);
+
+    ASSERT_TRUE(recorder.has_diagnostic());
+    EXPECT_EQ(bnb::error::value_out_of_range, recorder.diagnostic().error);
+    EXPECT_EQ(1U, recorder.diagnostic().position);
+    EXPECT_STREQ("length", recorder.diagnostic().field);
+    EXPECT_EQ(2U, recorder.diagnostic().actual);
+}
@@ -7,6 +7,10 @@
 #include <endian/big_endian.hpp>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 TEST(test_stream_reader, init)
 {
     std::vector<uint8_t> buffer(10);
@@ -241,6 +245,14 @@ TEST(test_stream_reader, read_bits)
     .get<1>().expect_eq(4)
     .get<2>(third_field);
 
+    EXPECT_TRUE(!error);
+
+    reader.seek(0);
+    reader.read_bits<bitter::u8, bitter::msb0, 1, 5, 2>()
+    .get<0>().expect_eq<1>()
+    .get<1>().expect_in_range<1, 4>()
+    .get<2>().expect([](uint8_t value) { return value == 2; });
+
     EXPECT_TRUE(!error);
     EXPECT_TRUE(!reader.error());
     EXPECT_EQ(true, first_field);
@@ -261,3 +273,259 @@ TEST(test_stream_reader, read_bits)
     EXPECT_TRUE((bool) error);
     EXPECT_EQ(42U, some_field);
 }
+
+TEST(test_stream_reader, read_array)
+{
+    std::vector<uint8_t> buffer = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    std::vector<uint16_t> peeked(3);
+    reader.peek_array<2>(peeked.data(), peeked.size(), 1);
+    EXPECT_EQ(std::vector<uint16_t>({0x0102, 0x0304, 0x0506}), peeked);
+    EXPECT_EQ(0U, reader.position());
+
+    std::vector<uint16_t> values(4);
+    reader.read_array<2>(values.data(), values.size()).expect_lt(0x0800);
+    EXPECT_EQ(std::vector<uint16_t>({0x0001, 0x0203, 0x0405, 0x0607}), values);
+    EXPECT_EQ(8U, reader.position());
+    EXPECT_TRUE(!error);
+
+    // Check that the element count can't overflow the bounds check
+    reader.peek_array<2>(values.data(), UINT64_MAX / 2 + 1);
+    EXPECT_TRUE((bool)error);
+}
+
+TEST(test_stream_reader, read_array_error)
+{
+    std::vector<uint8_t> buffer = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    std::vector<uint32_t> values(3, 42);
+    reader.read_array<4>(values.data(), values.size()); // force error
+    EXPECT_TRUE((bool)error);
+    EXPECT_EQ(std::vector<uint32_t>({42, 42, 42}), values);
+
+    // Validation failures are reported through the error code
+    std::error_code validation_error;
+    bnb::stream_reader<endian::big_endian> validating_reader(
+        buffer.data(), buffer.size(), validation_error);
+    validating_reader.read_array<4>(values.data(), 2).expect_gt(0x00010203U);
+    EXPECT_TRUE((bool)validation_error);
+}
+
+TEST(test_stream_reader, read_varint)
+{
+    std::vector<uint8_t> buffer = {0xE5, 0x8E, 0x26, 0x7B, 0xBD, 0x80, 0x02};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    uint32_t leb = 0;
+    reader.read_varint<bnb::leb128>(leb).expect_eq(624485U);
+    reader.read_varint<bnb::quic_varint>().expect_eq(15293U);
+    EXPECT_TRUE(!error);
+    EXPECT_EQ(624485U, leb);
+    EXPECT_EQ(5U, reader.position());
+
+    // 256 doesn't fit in a uint8_t
+    uint8_t small = 42;
+    reader.read_varint<bnb::leb128>(small);
+    EXPECT_EQ(std::errc::value_too_large, error);
+    EXPECT_EQ(42U, small);
+}
+
+TEST(test_stream_reader, read_varint_error)
+{
+    std::vector<uint8_t> overlong = {0x80, 0x00};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        overlong.data(), overlong.size(), error);
+    reader.read_varint<bnb::leb128>();
+    EXPECT_EQ(std::errc::illegal_byte_sequence, error);
+
+    std::vector<uint8_t> truncated = {0xC0, 0x00};
+    std::error_code truncated_error;
+    bnb::stream_reader<endian::big_endian> truncated_reader(
+        truncated.data(), truncated.size(), truncated_error);
+    truncated_reader.read_varint<bnb::quic_varint>();
+    EXPECT_EQ(std::errc::result_out_of_range, truncated_error);
+}
+
+TEST(test_stream_reader, read_view)
+{
+    std::vector<uint8_t> buffer = {0, 1, 2, 3, 4, 5};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto view = reader.read_view(2);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(buffer.data(), view.data());
+    EXPECT_EQ(2U, view.size());
+    EXPECT_EQ(2U, reader.position());
+
+    auto empty = reader.read_view(5);
+    EXPECT_TRUE((bool)error);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(nullptr, empty.data());
+}
+
+TEST(test_stream_reader, read_length_prefixed)
+{
+    std::vector<uint8_t> buffer = {0, 2, 'a', 'b', 0, 0, 0, 3, 'c'};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto first = reader.read_length_prefixed<2>();
+    auto second = reader.read_length_prefixed<2>();
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ("ab", std::string(first.begin(), first.end()));
+    EXPECT_TRUE(second.empty());
+
+    // The length exceeds the remaining data
+    auto third = reader.read_length_prefixed<2>();
+    EXPECT_TRUE((bool)error);
+    EXPECT_TRUE(third.empty());
+}
+
+TEST(test_stream_reader, peek_bytes_offset_overflow)
+{
+    std::vector<uint8_t> buffer {0, 1, 2};
+
+    // Offsets larger than the remaining size must not wrap around the
+    // bounds check
+    for (uint64_t offset :
+         {uint64_t(4), uint64_t(5), UINT64_MAX - 1, UINT64_MAX})
+    {
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint8_t value = 42;
+        reader.peek_bytes<1>(value, offset);
+        EXPECT_TRUE((bool)error);
+        EXPECT_EQ(42U, value);
+
+        std::error_code array_error;
+        bnb::stream_reader<endian::big_endian> array_reader(
+            buffer.data(), buffer.size(), array_error);
+        array_reader.peek_array<1>(&value, 1, offset);
+        EXPECT_TRUE((bool)array_error);
+        EXPECT_EQ(42U, value);
+    }
+}
+
+TEST(test_stream_reader, bounds_overflow)
+{
+    std::vector<uint8_t> buffer {0, 1, 2};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+    reader.read_bytes<1>();
+
+    reader.skip(UINT64_MAX);
+    EXPECT_TRUE((bool)error);
+    error.clear();
+    reader.seek(UINT64_MAX);
+    EXPECT_TRUE((bool)error);
+    error.clear();
+    reader.read_view(UINT64_MAX);
+    EXPECT_TRUE((bool)error);
+    error.clear();
+    reader.require(UINT64_MAX);
+    EXPECT_TRUE((bool)error);
+    error.clear();
+    uint64_t value = 0;
+    reader.read_array<8>(&value, UINT64_MAX / 4);
+    EXPECT_TRUE((bool)error);
+    error.clear();
+
+    EXPECT_EQ(1U, reader.position());
+}
+
+TEST(test_stream_reader, find)
+{
+    std::vector<uint8_t> buffer {0x12, 0x47, 0x00, 0x00, 0x00, 0x01, 0x09,
+                                 0x00, 0x01, 0x00, 0x00, 0x01, 0x47};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    uint64_t offset = 0;
+    EXPECT_TRUE(reader.find(0x47, offset));
+    EXPECT_EQ(1U, offset);
+    EXPECT_FALSE(reader.find(0x48, offset));
+
+    const uint8_t pattern[] = {0x01, 0x09};
+    EXPECT_TRUE(reader.find(pattern, sizeof(pattern), offset));
+    EXPECT_EQ(5U, offset);
+    EXPECT_EQ(0U, reader.position());
+
+    // The four byte start code is found at its second byte
+    EXPECT_TRUE(reader.seek_to_start_code());
+    EXPECT_EQ(3U, reader.position());
+    reader.skip(3);
+
+    // A 0x01 after a single zero byte is not a start code
+    EXPECT_TRUE(reader.seek_to_start_code());
+    EXPECT_EQ(9U, reader.position());
+    reader.skip(3);
+    EXPECT_FALSE(reader.seek_to_start_code());
+    EXPECT_EQ(12U, reader.position());
+
+    EXPECT_TRUE(reader.seek_to(0x47));
+    reader.read_bytes<1>().expect_eq(0x47);
+    EXPECT_FALSE(reader.seek_to(0x47));
+    EXPECT_FALSE((bool)error);
+
+    // An empty pattern is found at the read position, also at the end
+    offset = 1;
+    EXPECT_TRUE(reader.find(pattern, 0, offset));
+    EXPECT_EQ(0U, offset);
+    EXPECT_TRUE(reader.seek_to(pattern, 0));
+    EXPECT_EQ(13U, reader.position());
+    EXPECT_EQ(buffer.data(), bnb::detail::find_pattern(
+        buffer.data(), buffer.size(), pattern, 0));
+}
+
+TEST(test_stream_reader, find_random)
+{
+    // Compare with a byte by byte search
+    std::mt19937 random(3);
+    std::vector<uint8_t> buffer(1000);
+    for (auto& byte : buffer)
+        byte = (uint8_t)(random() % 3);
+
+    for (uint64_t size = 1; size <= 5; ++size)
+    {
+        std::vector<uint8_t> pattern(size);
+        for (auto& byte : pattern)
+            byte = (uint8_t)(random() % 3);
+
+        std::error_code error;
+        bnb::stream_reader<endian::big_endian> reader(
+            buffer.data(), buffer.size(), error);
+
+        uint64_t expected = 0;
+        while (true)
+        {
+            auto match = std::search(buffer.begin() + expected, buffer.end(),
+                                     pattern.begin(), pattern.end());
+            if (match == buffer.end())
+                break;
+            expected = match - buffer.begin();
+
+            EXPECT_TRUE(reader.seek_to(pattern.data(), pattern.size()));
+            EXPECT_EQ(expected, reader.position());
+            reader.skip(1);
+            ++expected;
+        }
+        EXPECT_FALSE(reader.seek_to(pattern.data(), pattern.size()));
+        EXPECT_FALSE((bool)error);
+    }
+}
@@ -0,0 +1,156 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stream_writer.hpp>
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_stream_writer, init)
+{
+    std::vector<uint8_t> buffer(10);
+    std::error_code error;
+    bnb::stream_writer<endian::big_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    ASSERT_FALSE((bool)error);
+    EXPECT_EQ(buffer.data(), writer.data());
+    EXPECT_EQ(buffer.size(), writer.size());
+
+    EXPECT_EQ(buffer.data(), writer.remaining_data());
+    EXPECT_EQ(buffer.size(), writer.remaining_size());
+
+    EXPECT_EQ(0U, writer.position());
+}
+
+TEST(test_stream_writer, write_bytes)
+{
+    std::vector<uint8_t> buffer(7, 0);
+    std::error_code error;
+    bnb::stream_writer<endian::big_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    writer.write_bytes<1>(0x01U);
+    writer.write_bytes<2>(0x0203U);
+    writer.write_bytes<4>(0x04050607U);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(0U, writer.remaining_size());
+
+    std::vector<uint8_t> expected {1, 2, 3, 4, 5, 6, 7};
+    EXPECT_EQ(expected, buffer);
+
+    // write out of bounds
+    writer.write_bytes<1>(0xFFU);
+    EXPECT_EQ(bnb::error::truncated, error);
+    EXPECT_EQ(expected, buffer);
+}
+
+TEST(test_stream_writer, write)
+{
+    std::vector<uint8_t> buffer(4, 0);
+    std::vector<uint8_t> data {1, 2, 3};
+    std::error_code error;
+    bnb::stream_writer<endian::little_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    writer.write(data.data(), data.size());
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(1U, writer.remaining_size());
+
+    writer.write(data.data(), data.size());
+    EXPECT_EQ(bnb::error::truncated, error);
+
+    std::vector<uint8_t> expected {1, 2, 3, 0};
+    EXPECT_EQ(expected, buffer);
+}
+
+TEST(test_stream_writer, skip)
+{
+    std::vector<uint8_t> buffer(4, 0);
+    std::error_code error;
+    bnb::stream_writer<endian::big_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    // Reserve room for a length field and fill it in afterwards
+    auto length = writer.skip(2);
+    writer.write_bytes<1>(0xAAU);
+    writer.write_bytes<1>(0xBBU);
+    length.write_bytes<2>(writer.position());
+
+    EXPECT_FALSE((bool)error);
+    std::vector<uint8_t> expected {0, 4, 0xAA, 0xBB};
+    EXPECT_EQ(expected, buffer);
+
+    auto writer_with_error = writer.skip(1);
+    EXPECT_EQ(bnb::error::invalid_seek, error);
+    EXPECT_TRUE((bool)writer_with_error.error());
+
+    // make sure we can still skip without crashing
+    auto another_writer_with_error = writer_with_error.skip(1);
+    EXPECT_TRUE((bool)another_writer_with_error.error());
+}
+
+TEST(test_stream_writer, seek)
+{
+    std::vector<uint8_t> buffer(4, 0);
+    std::error_code error;
+    bnb::stream_writer<endian::big_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    writer.seek(2);
+    writer.write_bytes<2>(0x0102U);
+    writer.seek(0);
+    writer.write_bytes<1>(0x03U);
+    EXPECT_FALSE((bool)error);
+
+    std::vector<uint8_t> expected {3, 0, 1, 2};
+    EXPECT_EQ(expected, buffer);
+
+    writer.seek(writer.size() + 1);
+    EXPECT_EQ(bnb::error::invalid_seek, error);
+
+    // Make sure we stay in error state even though we seek back to a
+    // valid point
+    writer.seek(1);
+    EXPECT_TRUE((bool)error);
+}
+
+TEST(test_stream_writer, write_bits)
+{
+    std::vector<uint8_t> buffer(3, 0xFF);
+    std::error_code error;
+    bnb::stream_writer<endian::big_endian> writer(
+        buffer.data(), buffer.size(), error);
+
+    writer.write_bits<bitter::u8, bitter::msb0, 1, 5, 2>()
+    .set<0>(true)
+    .set<1>(4U)
+    .set<2>(2U);
+
+    writer.write_bits<bitter::u16, bitter::lsb0, 4, 12>()
+    .set<0>(0xAU)
+    .set<1>(0x123U);
+
+    EXPECT_FALSE((bool)error);
+    std::vector<uint8_t> expected {0b10010010, 0x12, 0x3A};
+    EXPECT_EQ(expected, buffer);
+
+    // Check that the written bits are read back by the stream reader
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+    uint8_t third_field = 0;
+    reader.read_bits<bitter::u8, bitter::msb0, 1, 5, 2>()
+    .get<0>().expect_eq(1U)
+    .get<1>().expect_eq(4U)
+    .get<2>(third_field);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(2U, third_field);
+
+    // check that if we write too much data we will get an error
+    writer.write_bits<bitter::u8, bitter::msb0, 8>() // force error
+    .set<0>(42U);
+    EXPECT_EQ(bnb::error::truncated, error);
+    EXPECT_EQ(expected, buffer);
+}
@@ -0,0 +1,120 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/tlv_reader.hpp>
+#include <bnb/status.hpp>
+#include <bnb/stream_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(test_tlv_reader, next)
+{
+    std::vector<uint8_t> buffer {1, 2, 0xAA, 0xBB, 7, 0, 3, 1, 0xCC};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+    bnb::tlv_reader<1, 1, decltype(reader)> entries(reader);
+
+    bnb::tlv_entry entry;
+    ASSERT_TRUE(entries.next(entry));
+    EXPECT_EQ(1U, entry.type);
+    EXPECT_EQ(buffer.data() + 2, entry.value.data());
+    EXPECT_EQ(2U, entry.value.size());
+
+    ASSERT_TRUE(entries.next(entry));
+    EXPECT_EQ(7U, entry.type);
+    EXPECT_TRUE(entry.value.empty());
+
+    ASSERT_TRUE(entries.next(entry));
+    EXPECT_EQ(3U, entry.type);
+    EXPECT_EQ(1U, entry.value.size());
+    EXPECT_EQ(0xCCU, entry.value[0]);
+
+    EXPECT_FALSE(entries.next(entry));
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(buffer.size(), reader.position());
+}
+
+TEST(test_tlv_reader, widths_and_endianness)
+{
+    // 2 byte types and 4 byte lengths in little endian
+    std::vector<uint8_t> buffer
+        {0x34, 0x12, 2, 0, 0, 0, 5, 6, 0xFF, 0xFF, 0, 0, 0, 0};
+    std::error_code error;
+    bnb::stream_reader<endian::little_endian> reader(
+        buffer.data(), buffer.size(), error);
+    bnb::tlv_reader<2, 4, decltype(reader)> entries(reader);
+
+    std::vector<uint64_t> types;
+    std::vector<uint64_t> sizes;
+    for (const bnb::tlv_entry& entry : entries)
+    {
+        types.push_back(entry.type);
+        sizes.push_back(entry.value.size());
+    }
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(std::vector<uint64_t>({0x1234, 0xFFFF}), types);
+    EXPECT_EQ(std::vector<uint64_t>({2, 0}), sizes);
+}
+
+TEST(test_tlv_reader, find)
+{
+    std::vector<uint8_t> buffer
+        {1, 2, 0xAA, 0xBB, 2, 1, 0xCC, 3, 1, 0xDD, 2, 1, 0xEE};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+    bnb::tlv_reader<1, 1, decltype(reader)> entries(reader);
+
+    bnb::tlv_entry entry;
+    ASSERT_TRUE(entries.find(2, entry));
+    EXPECT_EQ(0xCCU, entry.value[0]);
+
+    // The search continues after the last found entry
+    ASSERT_TRUE(entries.find(2, entry));
+    EXPECT_EQ(0xEEU, entry.value[0]);
+
+    EXPECT_FALSE(entries.find(2, entry));
+    EXPECT_FALSE((bool)error);
+}
+
+TEST(test_tlv_reader, malformed_length)
+{
+    // The length of the second entry exceeds the remaining data
+    std::vector<uint8_t> buffer {1, 1, 0xAA, 2, 5, 0xBB, 0xCC};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+    bnb::tlv_reader<1, 1, decltype(reader)> entries(reader);
+
+    uint32_t count = 0;
+    for (const bnb::tlv_entry& entry : entries)
+    {
+        EXPECT_EQ(1U, entry.type);
+        ++count;
+    }
+    EXPECT_EQ(1U, count);
+    EXPECT_EQ(bnb::error::truncated, error);
+
+    bnb::tlv_entry entry;
+    EXPECT_FALSE(entries.next(entry));
+}
+
+TEST(test_tlv_reader, truncated_header)
+{
+    std::vector<uint8_t> buffer {1, 0, 0};
+    bnb::status error;
+    bnb::stream_reader<endian::big_endian, bnb::no_diagnostics,
+                       bnb::no_stats, bnb::status> reader(
+        buffer.data(), buffer.size(), error);
+    bnb::tlv_reader<1, 1, decltype(reader)> entries(reader);
+
+    bnb::tlv_entry entry;
+    EXPECT_FALSE(entries.find(3, entry));
+    EXPECT_EQ(bnb::error::truncated, error.value());
+}
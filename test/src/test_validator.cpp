@@ -154,4 +154,74 @@ TEST(test_validator, expect)
         return true;
     });
     ASSERT_FALSE(!error);
-}
\ No newline at end of file
+}
+
+TEST(test_validator, expect_std_function)
+{
+    std::error_code error;
+    auto validator = bnb::validator<uint32_t>(42, error);
+    std::function<bool(uint32_t)> is_42 = [](uint32_t value)
+    {
+        return value == 42;
+    };
+    std::function<bool(uint32_t)> is_43 = [](uint32_t value)
+    {
+        return value == 43;
+    };
+
+    validator.expect(is_42);
+    ASSERT_TRUE(!error);
+
+    validator.expect(is_43);
+    ASSERT_FALSE(!error);
+}
+
+TEST(test_validator, expect_eq_constant)
+{
+    std::error_code error;
+    auto validator = bnb::validator<uint32_t>(42, error);
+    validator.expect_eq<42>();
+    ASSERT_TRUE(!error);
+    validator.expect_ne<43>();
+    ASSERT_TRUE(!error);
+
+    validator.expect_eq<43>();
+    ASSERT_FALSE(!error);
+}
+
+TEST(test_validator, expect_in_range)
+{
+    std::error_code error;
+    auto validator = bnb::validator<uint32_t>(42, error);
+    validator.expect_in_range<0, 42>();
+    ASSERT_TRUE(!error);
+    validator.expect_in_range<42, 42>();
+    ASSERT_TRUE(!error);
+    validator.expect_in_range<41, 100>();
+    ASSERT_TRUE(!error);
+
+    validator.expect_in_range<43, 100>();
+    ASSERT_FALSE(!error);
+
+    // make sure we don't crash after a failed validation has happened and the
+    // error is still there
+    validator.expect_in_range<0, 100>();
+    ASSERT_FALSE(!error);
+
+    std::error_code upper_error;
+    bnb::validator<int32_t>(-1, upper_error).expect_in_range<-10, -2>();
+    ASSERT_FALSE(!upper_error);
+}
+
+TEST(test_validator, floating_point)
+{
+    std::error_code error;
+    auto validator = bnb::validator<double>(1.5, error);
+    validator.expect_gt(1.0);
+    validator.expect_lt(2.0);
+    validator.expect([](double value) { return value == 1.5; });
+    ASSERT_TRUE(!error);
+
+    validator.expect_eq(2.5);
+    ASSERT_FALSE(!error);
+}
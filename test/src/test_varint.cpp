@@ -0,0 +1,143 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/varint.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<uint8_t> encode_leb128(uint64_t value)
+{
+    std::vector<uint8_t> data;
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        data.push_back(value != 0 ? byte | 0x80 : byte);
+    }
+    while (value != 0);
+    return data;
+}
+
+// Decodes the encoding with and without padding, to cover both the fast
+// path and the slow path used near the end of a buffer
+template<class Format>
+void check_decode(std::vector<uint8_t> data, uint64_t expected)
+{
+    uint64_t size = data.size();
+
+    uint64_t value = 0;
+    EXPECT_EQ(size, Format::decode(data.data(), data.size(), value));
+    EXPECT_EQ(expected, value);
+
+    data.resize(16, 0xFF);
+    value = 0;
+    EXPECT_EQ(size, Format::decode(data.data(), data.size(), value));
+    EXPECT_EQ(expected, value);
+}
+
+template<class Format>
+void check_invalid(std::vector<uint8_t> data)
+{
+    uint64_t value = 42;
+    EXPECT_EQ(0U, Format::decode(data.data(), data.size(), value));
+    data.resize(16, 0xFF);
+    EXPECT_EQ(0U, Format::decode(data.data(), data.size(), value));
+    EXPECT_EQ(42U, value);
+}
+}
+
+TEST(test_varint, leb128)
+{
+    check_decode<bnb::leb128>({0x00}, 0);
+    check_decode<bnb::leb128>({0x7F}, 127);
+    check_decode<bnb::leb128>({0xE5, 0x8E, 0x26}, 624485);
+
+    for (uint32_t shift = 0; shift < 64; ++shift)
+    {
+        uint64_t value = (1ULL << shift) | (shift * 0x01010101ULL);
+        check_decode<bnb::leb128>(encode_leb128(value), value);
+        check_decode<bnb::leb128>(encode_leb128(value - 1), value - 1);
+    }
+    check_decode<bnb::leb128>(encode_leb128(UINT64_MAX), UINT64_MAX);
+}
+
+TEST(test_varint, leb128_invalid)
+{
+    // Overlong encodings
+    check_invalid<bnb::leb128>({0x80, 0x00});
+    check_invalid<bnb::leb128>({0xFF, 0x80, 0x00});
+    check_invalid<bnb::leb128>(
+        {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00});
+
+    // More than 64 bits
+    check_invalid<bnb::leb128>(
+        {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02});
+
+    uint64_t value = 0;
+    std::vector<uint8_t> too_long(16, 0x80);
+    EXPECT_EQ(0U, bnb::leb128::decode(too_long.data(), too_long.size(), value));
+}
+
+TEST(test_varint, leb128_truncated)
+{
+    std::vector<uint8_t> data {0x80, 0x80, 0x80};
+    uint64_t value = 42;
+    EXPECT_EQ(4U, bnb::leb128::decode(data.data(), data.size(), value));
+    EXPECT_EQ(1U, bnb::leb128::decode(data.data(), 0, value));
+    EXPECT_EQ(42U, value);
+}
+
+TEST(test_varint, quic)
+{
+    // The examples from RFC 9000 appendix A.1
+    check_decode<bnb::quic_varint>(
+        {0xC2, 0x19, 0x7C, 0x5E, 0xFF, 0x14, 0xE8, 0x8C}, 151288809941952652);
+    check_decode<bnb::quic_varint>({0x9D, 0x7F, 0x3E, 0x7D}, 494878333);
+    check_decode<bnb::quic_varint>({0x7B, 0xBD}, 15293);
+    check_decode<bnb::quic_varint>({0x25}, 37);
+
+    check_decode<bnb::quic_varint>({0x3F}, 63);
+    check_decode<bnb::quic_varint>({0x40, 0x40}, 64);
+    check_decode<bnb::quic_varint>(
+        {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, (1ULL << 62) - 1);
+}
+
+TEST(test_varint, quic_non_minimal)
+{
+    // RFC 9000 allows encodings longer than needed, e.g. 37 in two bytes
+    check_decode<bnb::quic_varint>({0x40, 0x25}, 37);
+    check_decode<bnb::quic_varint>({0x80, 0x00, 0x3F, 0xFF}, 16383);
+    check_decode<bnb::quic_varint>(
+        {0xC0, 0x00, 0x00, 0x00, 0x3F, 0xFF, 0xFF, 0xFF}, 1073741823);
+}
+
+TEST(test_varint, quic_strict)
+{
+    check_decode<bnb::quic_varint_strict>({0x25}, 37);
+    check_decode<bnb::quic_varint_strict>({0x40, 0x40}, 64);
+    check_decode<bnb::quic_varint_strict>({0x9D, 0x7F, 0x3E, 0x7D},
+                                          494878333);
+
+    // Encodings longer than needed
+    check_invalid<bnb::quic_varint_strict>({0x40, 0x25});
+    check_invalid<bnb::quic_varint_strict>({0x80, 0x00, 0x3F, 0xFF});
+    check_invalid<bnb::quic_varint_strict>(
+        {0xC0, 0x00, 0x00, 0x00, 0x3F, 0xFF, 0xFF, 0xFF});
+
+    std::vector<uint8_t> data {0x9D, 0x7F};
+    uint64_t value = 0;
+    EXPECT_EQ(4U, bnb::quic_varint_strict::decode(
+        data.data(), data.size(), value));
+}
+
+TEST(test_varint, quic_truncated)
+{
+    std::vector<uint8_t> data {0x9D, 0x7F, 0x3E};
+    uint64_t value = 42;
+    EXPECT_EQ(4U, bnb::quic_varint::decode(data.data(), data.size(), value));
+    EXPECT_EQ(1U, bnb::quic_varint::decode(data.data(), 0, value));
+    EXPECT_EQ(42U, value);
+}
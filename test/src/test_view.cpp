@@ -0,0 +1,39 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/view.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(test_view, api)
+{
+    std::vector<uint8_t> buffer {1, 2, 3};
+    bnb::view view(buffer.data(), buffer.size());
+
+    EXPECT_EQ(buffer.data(), view.data());
+    EXPECT_EQ(3U, view.size());
+    EXPECT_FALSE(view.empty());
+    EXPECT_EQ(2U, view[1]);
+    EXPECT_EQ(buffer, std::vector<uint8_t>(view.begin(), view.end()));
+}
+
+TEST(test_view, empty)
+{
+    bnb::view view;
+    EXPECT_EQ(nullptr, view.data());
+    EXPECT_EQ(0U, view.size());
+    EXPECT_TRUE(view.empty());
+    EXPECT_EQ(view.begin(), view.end());
+}
+
+TEST(test_view, zero_size)
+{
+    std::vector<uint8_t> buffer {1, 2, 3};
+    bnb::view view(buffer.data() + 1, 0);
+    EXPECT_EQ(buffer.data() + 1, view.data());
+    EXPECT_TRUE(view.empty());
+    EXPECT_EQ(view.begin(), view.end());
+}
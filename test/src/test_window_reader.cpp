@@ -0,0 +1,133 @@
+// Copyright (c) Steinwurf ApS 2017.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <bnb/stream_reader.hpp>
+#include <bnb/window_reader.hpp>
+#include <endian/big_endian.hpp>
+#include <gtest/gtest.h>
+
+TEST(test_window_reader, require)
+{
+    std::vector<uint8_t> buffer {0, 1, 2, 3, 0b10010010, 5, 6, 7, 8, 9};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    uint8_t byte0 = 0;
+    uint16_t bytes12 = 0;
+    uint8_t byte3 = 0;
+    bool first_field = false;
+    uint8_t third_field = 0;
+
+    auto window = reader.require(5);
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(5U, window.size());
+    EXPECT_EQ(5U, reader.position());
+
+    window.read_bytes<1>(byte0).expect_eq(0U);
+    window.read_bytes<2>(bytes12);
+    window.peek_bytes<1>(byte3);
+    window.read_bytes<1>().expect_eq(3U);
+    window.read_bits<bitter::u8, bitter::msb0, 1, 5, 2>()
+    .get<0>(first_field)
+    .get<1>().expect_eq(4U)
+    .get<2>(third_field);
+
+    EXPECT_FALSE((bool)error);
+    EXPECT_EQ(0U, window.remaining_size());
+    EXPECT_EQ(0U, byte0);
+    EXPECT_EQ(0x0102U, bytes12);
+    EXPECT_EQ(3U, byte3);
+    EXPECT_TRUE(first_field);
+    EXPECT_EQ(2U, third_field);
+
+    // The remaining bytes can still be read from the stream reader
+    reader.read_bytes<1>().expect_eq(5U);
+    EXPECT_FALSE((bool)error);
+
+    // Requiring more bytes than available sets the error
+    auto empty = reader.require(5);
+    EXPECT_TRUE((bool)error);
+    EXPECT_EQ(0U, empty.size());
+
+    // Make sure we can still read from the empty window without crashing
+    uint8_t initial_value = 88;
+    uint8_t value = initial_value;
+    empty.read_bytes<1>(value);
+    empty.read_bits<bitter::u8, bitter::msb0, 8>().get<0>(value);
+    EXPECT_EQ(initial_value, value);
+}
+
+TEST(test_window_reader, validation_error)
+{
+    std::vector<uint8_t> buffer {0, 1, 2, 3};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    uint8_t byte0 = 0;
+    uint8_t byte1 = 0;
+    uint8_t byte2 = 0;
+
+    auto window = reader.require(4);
+    window.read_bytes<1>(byte0).expect_eq(1U); // force error
+    window.read_bytes<1>(byte1);
+    window.read_bytes<1>(byte2);
+
+    EXPECT_TRUE((bool)error);
+    EXPECT_TRUE((bool)window.error());
+    EXPECT_EQ(0U, byte0);
+    EXPECT_EQ(0U, byte1);
+    EXPECT_EQ(0U, byte2);
+}
+
+TEST(test_window_reader, skip)
+{
+    std::vector<uint8_t> buffer {0, 1, 2, 3};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto window = reader.require(4);
+    auto skipped = window.skip(2);
+    skipped.read_bytes<2>().expect_eq(0x0001U);
+    window.read_bytes<2>().expect_eq(0x0203U);
+    EXPECT_FALSE((bool)error);
+}
+
+TEST(test_window_reader, skip_out_of_bounds)
+{
+    std::vector<uint8_t> buffer {0, 1, 2, 3, 4};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto window = reader.require(4);
+    auto skipped = window.skip(5);
+    EXPECT_EQ(bnb::error::invalid_seek, error);
+    EXPECT_EQ(0U, skipped.size());
+}
+
+TEST(test_window_reader, peek_out_of_bounds)
+{
+    std::vector<uint8_t> buffer {0, 1, 2, 3, 4};
+    std::error_code error;
+    bnb::stream_reader<endian::big_endian> reader(
+        buffer.data(), buffer.size(), error);
+
+    auto window = reader.require(4);
+    window.peek_bytes<2>(2).expect_eq(0x0203U);
+    EXPECT_FALSE((bool)error);
+
+    uint16_t value = 0;
+    window.peek_bytes<2>(value, 3);
+    EXPECT_EQ(bnb::error::truncated, error);
+    EXPECT_EQ(0U, value);
+
+    // An offset past the window doesn't wrap around the bounds check
+    error.clear();
+    window.peek_bytes<1>(value, UINT64_MAX);
+    EXPECT_EQ(bnb::error::truncated, error);
+}